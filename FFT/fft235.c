@@ -22,11 +22,17 @@ C
 
 #include "hpccfft.h"
 
+/* butterflies selected by HPCC_fft235_kernels(); the scalar code below is used where they are
+   NULL or decline the pass */
+static HPCC_FFTKernels *Kernels = HPCC_FFTKernelVariants;
+
 static void
 fft2(fftw_complex *a, fftw_complex *b, int m) {
   int i, lda, ldb;
   double x0, x1, y0, y1;
 
+  if (Kernels->fft2 && Kernels->fft2( a, b, m )) return;
+
   lda = m;
   ldb = m;
 
@@ -603,6 +609,8 @@ fft5b(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l) {
 
 static void
 fft3(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l) {
+  if (Kernels->fft3 && Kernels->fft3( a, b, w, m, l ))
+    return;
   if (1 == m)
     fft3a( a, b, w, l );
   else
@@ -611,6 +619,8 @@ fft3(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l) {
 
 static void
 fft4(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l) {
+  if (Kernels->fft4 && Kernels->fft4( a, b, w, m, l ))
+    return;
   if (1 == m)
     fft4a( a, b, w, l );
   else
@@ -619,6 +629,8 @@ fft4(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l) {
 
 static void
 fft5(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l) {
+  if (Kernels->fft5 && Kernels->fft5( a, b, w, m, l ))
+    return;
   if (1 == m)
     fft5a( a, b, w, l );
   else
@@ -627,6 +639,8 @@ fft5(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l) {
 
 static void
 fft8(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l) {
+  if (Kernels->fft8 && Kernels->fft8( a, b, w, m, l ))
+    return;
   if (1 == m)
     fft8a( a, b, w, l );
   else
@@ -742,6 +756,23 @@ HPCC_fft235(fftw_complex *a, fftw_complex *b, fftw_complex *w, int n, const int
   return 0;
 }
 
+/* Selects the butterflies of HPCC_fft235: 0 for the widest SIMD kernels that the CPU supports, 1
+   for the scalar code, 2 for AVX2 and 3 for AVX-512 (or the next narrower kernels if the CPU
+   does not support them). Returns the kernels that were selected with the same numbering. */
+int
+HPCC_fft235_kernels(int kernels) {
+  int v;
+
+  v = kernels > 0 ? kernels - 1 : HPCC_FFT_KERNEL_VARIANTS - 1;
+  if (v >= HPCC_FFT_KERNEL_VARIANTS) v = HPCC_FFT_KERNEL_VARIANTS - 1;
+  for (; v > 0 && ! HPCC_FFTKernelsAvailable( v ); v--)
+    ; /* EMPTY */
+
+  Kernels = HPCC_FFTKernelVariants + v;
+
+  return v + 1;
+}
+
 static int
 settbl0(fftw_complex *w, int m, int l) {
   int i;
@@ -0,0 +1,235 @@
+/* -*- mode: C; tab-width: 2; indent-tabs-mode: nil; fill-column: 79; coding: iso-latin-1-unix -*- */
+/*
+  SIMD versions of the radix-2, 3, 4, 5 and 8 butterflies of FFTE (see
+  fft235.c, whose scalar code remains the reference).
+
+  The data is kept in the interleaved layout of fftw_complex: a vector holds 2
+  (AVX2) or 4 (AVX-512) complex numbers. A complex product is computed with an
+  FMADDSUB of the vector times the duplicated real parts of the factor and of
+  the vector with swapped halves times the duplicated imaginary parts. The
+  butterflies with m > 1 are vectorized over the contiguous index i and share
+  the twiddle factors of j; the first pass (m == 1) is vectorized over j and
+  reads the twiddle factors of the lanes from the table. A kernel returns 0
+  without touching the data if the number of butterflies is not a multiple of
+  the vector length, and the scalar code is used instead.
+
+  As in STREAM/kernels.c the kernels are compiled with GCC's target attributes
+  and their availability is checked at runtime with cpuid.
+ */
+
+#include <hpcc.h>
+
+#include "hpccfft.h"
+
+#if defined(__GNUC__) && defined(__x86_64__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define HPCC_FFT_X86 1
+#include <immintrin.h>
+#endif
+
+#ifdef HPCC_FFT_X86
+
+/* z * w and -i * z for vectors of complex numbers */
+#define CMUL(z, w) VFMADDSUB( z, VDUPRE( w ), VMUL( VSWAP( z ), VDUPIM( w ) ) )
+#define MULNI(z) VMUL( VSWAP( z ), VPM )
+
+/* loads and stores of input/output k of the first pass (LDA, STA) and of the others (LDB, STB) */
+#define LDA(k) VLD( PTR2D( a, j, k, l ) )
+#define STA(k, v) { VT t_ = (v); VSTC( PTR2D( b, k, j, ldb ), ldb, t_ ); }
+#define LDB(k) VLD( PTR3D( a, i, j, k, m, l ) )
+#define STB(k, v) VST( PTR3D( b, i, k, j, m, ldb ), v )
+
+#define TWIDDLE(k, v) CMUL( v, W##k )
+#define NOTWIDDLE(k, v) (v)
+
+/* powers of the twiddle factor W1 used by the butterflies */
+#define FFT3_POWERS , W2 = CMUL( W1, W1 )
+#define FFT4_POWERS FFT3_POWERS, W3 = CMUL( W1, W2 )
+#define FFT5_POWERS FFT4_POWERS, W4 = CMUL( W2, W2 )
+#define FFT8_POWERS FFT5_POWERS, W5 = CMUL( W2, W3 ), W6 = CMUL( W3, W3 ), W7 = CMUL( W3, W4 )
+
+#define FFT3_BUTTERFLY(LD, ST, TW) { \
+  VT a0 = LD( 0 ), a1 = LD( 1 ), a2 = LD( 2 ); \
+  VT x0 = VADD( a1, a2 ); \
+  VT x1 = VSUB( a0, VMUL( VSET1( 0.5 ), x0 ) ); \
+  VT x2 = VMUL( VSET1( 0.86602540378443865 ), MULNI( VSUB( a1, a2 ) ) ); \
+  ST( 0, VADD( a0, x0 ) ); \
+  ST( 1, TW( 1, VADD( x1, x2 ) ) ); \
+  ST( 2, TW( 2, VSUB( x1, x2 ) ) ); \
+}
+
+#define FFT4_BUTTERFLY(LD, ST, TW) { \
+  VT a0 = LD( 0 ), a1 = LD( 1 ), a2 = LD( 2 ), a3 = LD( 3 ); \
+  VT x0 = VADD( a0, a2 ), x1 = VSUB( a0, a2 ); \
+  VT x2 = VADD( a1, a3 ), x3 = MULNI( VSUB( a1, a3 ) ); \
+  ST( 0, VADD( x0, x2 ) ); \
+  ST( 2, TW( 2, VSUB( x0, x2 ) ) ); \
+  ST( 1, TW( 1, VADD( x1, x3 ) ) ); \
+  ST( 3, TW( 3, VSUB( x1, x3 ) ) ); \
+}
+
+#define FFT5_BUTTERFLY(LD, ST, TW) { \
+  VT a0 = LD( 0 ), a1 = LD( 1 ), a2 = LD( 2 ), a3 = LD( 3 ), a4 = LD( 4 ); \
+  VT c51 = VSET1( 0.95105651629515357 ), c52 = VSET1( 0.61803398874989485 ); \
+  VT x0 = VADD( a1, a4 ), x1 = VADD( a2, a3 ); \
+  VT x2 = VMUL( c51, VSUB( a1, a4 ) ), x3 = VMUL( c51, VSUB( a2, a3 ) ); \
+  VT x4 = VADD( x0, x1 ), x5 = VMUL( VSET1( 0.55901699437494742 ), VSUB( x0, x1 ) ); \
+  VT x6 = VSUB( a0, VMUL( VSET1( 0.25 ), x4 ) ); \
+  VT x7 = VADD( x6, x5 ), x8 = VSUB( x6, x5 ); \
+  VT x9 = MULNI( VADD( x2, VMUL( c52, x3 ) ) ), x10 = MULNI( VSUB( VMUL( c52, x2 ), x3 ) ); \
+  ST( 0, VADD( a0, x4 ) ); \
+  ST( 1, TW( 1, VADD( x7, x9 ) ) ); \
+  ST( 2, TW( 2, VADD( x8, x10 ) ) ); \
+  ST( 3, TW( 3, VSUB( x8, x10 ) ) ); \
+  ST( 4, TW( 4, VSUB( x7, x9 ) ) ); \
+}
+
+#define FFT8_BUTTERFLY(LD, ST, TW) { \
+  VT a0 = LD( 0 ), a1 = LD( 1 ), a2 = LD( 2 ), a3 = LD( 3 ); \
+  VT a4 = LD( 4 ), a5 = LD( 5 ), a6 = LD( 6 ), a7 = LD( 7 ); \
+  VT c81 = VSET1( 0.70710678118654752 ); \
+  VT x0 = VADD( a0, a4 ), x2 = VADD( a2, a6 ), x4 = VADD( a1, a5 ), x6 = VADD( a3, a7 ); \
+  VT u0 = VADD( x0, x2 ), u1 = VSUB( x0, x2 ), u2 = VADD( x4, x6 ), u3 = MULNI( VSUB( x4, x6 ) ); \
+  VT x1 = VSUB( a0, a4 ), x3 = MULNI( VSUB( a2, a6 ) ), x5 = VSUB( a1, a5 ), x7 = VSUB( a3, a7 ); \
+  VT s = VMUL( c81, VSUB( x5, x7 ) ), t = VMUL( c81, MULNI( VADD( x5, x7 ) ) ); \
+  VT v0 = VADD( x1, s ), v1 = VSUB( x1, s ), v2 = VADD( x3, t ), v3 = VSUB( x3, t ); \
+  ST( 0, VADD( u0, u2 ) ); \
+  ST( 4, TW( 4, VSUB( u0, u2 ) ) ); \
+  ST( 2, TW( 2, VADD( u1, u3 ) ) ); \
+  ST( 6, TW( 6, VSUB( u1, u3 ) ) ); \
+  ST( 1, TW( 1, VADD( v0, v2 ) ) ); \
+  ST( 5, TW( 5, VADD( v1, v3 ) ) ); \
+  ST( 3, TW( 3, VSUB( v1, v3 ) ) ); \
+  ST( 7, TW( 7, VSUB( v0, v2 ) ) ); \
+}
+
+/*
+  Defines the radix-R kernel for the vector type VT of NC complex numbers. In
+  the last passes (l == 1) `a' and `b' are the same array: every butterfly
+  loads all its inputs before it stores its outputs.
+ */
+#define HPCC_FFT_RADIX(sfx, tgt, R) \
+static int __attribute__((target(tgt))) \
+sfx##Fft##R(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l) { \
+  int i, j, ldb = R; \
+  if (1 == m) { \
+    if (l % NC) return 0; \
+    for (j = 0; j < l; j += NC) { \
+      VT W1 = VLD( w + j ) FFT##R##_POWERS; \
+      FFT##R##_BUTTERFLY( LDA, STA, TWIDDLE ) \
+    } \
+    return 1; \
+  } \
+  if (m % NC) return 0; \
+  for (j = 0, i = 0; i < m; i += NC) \
+    FFT##R##_BUTTERFLY( LDB, STB, NOTWIDDLE ) \
+  for (j = 1; j < l; j++) { \
+    VT W1 = VBCASTC( w + j ) FFT##R##_POWERS; \
+    for (i = 0; i < m; i += NC) \
+      FFT##R##_BUTTERFLY( LDB, STB, TWIDDLE ) \
+  } \
+  return 1; \
+}
+
+#define HPCC_FFT_SIMD(sfx, tgt) \
+static int __attribute__((target(tgt))) \
+sfx##Fft2(fftw_complex *a, fftw_complex *b, int m) { \
+  int i; \
+  if (m % NC) return 0; \
+  for (i = 0; i < m; i += NC) { \
+    VT a0 = VLD( a + i ), a1 = VLD( a + i + m ); \
+    VST( b + i, VADD( a0, a1 ) ); \
+    VST( b + i + m, VSUB( a0, a1 ) ); \
+  } \
+  return 1; \
+} \
+HPCC_FFT_RADIX(sfx, tgt, 3) \
+HPCC_FFT_RADIX(sfx, tgt, 4) \
+HPCC_FFT_RADIX(sfx, tgt, 5) \
+HPCC_FFT_RADIX(sfx, tgt, 8)
+
+/* AVX2: 2 complex numbers per vector */
+#define VT __m256d
+#define NC 2
+#define VLD(p) _mm256_loadu_pd( (double *)(p) )
+#define VST(p, v) _mm256_storeu_pd( (double *)(p), v )
+#define VSTC(p, ld, v) \
+  _mm_storeu_pd( (double *)(p), _mm256_castpd256_pd128( v ) ); \
+  _mm_storeu_pd( (double *)((p) + (ld)), _mm256_extractf128_pd( v, 1 ) )
+#define VBCASTC(p) _mm256_broadcast_pd( (__m128d *)(p) )
+#define VSET1 _mm256_set1_pd
+#define VADD _mm256_add_pd
+#define VSUB _mm256_sub_pd
+#define VMUL _mm256_mul_pd
+#define VFMADDSUB _mm256_fmaddsub_pd
+#define VSWAP(z) _mm256_permute_pd( z, 0x5 )
+#define VDUPRE(z) _mm256_movedup_pd( z )
+#define VDUPIM(z) _mm256_permute_pd( z, 0xF )
+#define VPM _mm256_setr_pd( 1.0, -1.0, 1.0, -1.0 )
+
+HPCC_FFT_SIMD(AVX2, "avx2,fma")
+
+#undef VT
+#undef NC
+#undef VLD
+#undef VST
+#undef VSTC
+#undef VBCASTC
+#undef VSET1
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VFMADDSUB
+#undef VSWAP
+#undef VDUPRE
+#undef VDUPIM
+#undef VPM
+
+/* AVX-512: 4 complex numbers per vector */
+#define VT __m512d
+#define NC 4
+#define VLD(p) _mm512_loadu_pd( (double *)(p) )
+#define VST(p, v) _mm512_storeu_pd( (double *)(p), v )
+#define VSTC(p, ld, v) \
+  _mm_storeu_pd( (double *)(p), _mm512_castpd512_pd128( v ) ); \
+  _mm_storeu_pd( (double *)((p) + (ld)), _mm256_extractf128_pd( _mm512_castpd512_pd256( v ), 1 ) ); \
+  _mm_storeu_pd( (double *)((p) + 2*(ld)), _mm256_castpd256_pd128( _mm512_extractf64x4_pd( v, 1 ) ) ); \
+  _mm_storeu_pd( (double *)((p) + 3*(ld)), _mm256_extractf128_pd( _mm512_extractf64x4_pd( v, 1 ), 1 ) )
+#define VBCASTC(p) _mm512_castps_pd( _mm512_broadcast_f32x4( _mm_loadu_ps( (float *)(p) ) ) )
+#define VSET1 _mm512_set1_pd
+#define VADD _mm512_add_pd
+#define VSUB _mm512_sub_pd
+#define VMUL _mm512_mul_pd
+#define VFMADDSUB _mm512_fmaddsub_pd
+#define VSWAP(z) _mm512_permute_pd( z, 0x55 )
+#define VDUPRE(z) _mm512_movedup_pd( z )
+#define VDUPIM(z) _mm512_permute_pd( z, 0xFF )
+#define VPM _mm512_setr_pd( 1.0, -1.0, 1.0, -1.0, 1.0, -1.0, 1.0, -1.0 )
+
+HPCC_FFT_SIMD(AVX512, "avx512f")
+
+#define HPCC_FFT_KERNELS_OF(sfx) sfx##Fft2, sfx##Fft3, sfx##Fft4, sfx##Fft5, sfx##Fft8
+#else
+#define HPCC_FFT_KERNELS_OF(sfx) NULL, NULL, NULL, NULL, NULL
+#endif
+
+HPCC_FFTKernels HPCC_FFTKernelVariants[HPCC_FFT_KERNEL_VARIANTS] = {
+  {"Scalar", NULL, NULL, NULL, NULL, NULL},
+  {"AVX2", HPCC_FFT_KERNELS_OF(AVX2)},
+  {"AVX512", HPCC_FFT_KERNELS_OF(AVX512)}
+};
+
+/* Returns non-zero if the variant was compiled in and the CPU supports it */
+int
+HPCC_FFTKernelsAvailable(int v) {
+  if (v < 0 || v >= HPCC_FFT_KERNEL_VARIANTS) return 0;
+  if (0 == v) return 1;
+  if (! HPCC_FFTKernelVariants[v].fft2) return 0;
+
+#ifdef HPCC_FFT_X86
+  __builtin_cpu_init();
+  if (2 == v) return __builtin_cpu_supports( "avx512f" );
+  return __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" );
+#else
+  return 0;
+#endif
+}
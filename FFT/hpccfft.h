@@ -50,6 +50,21 @@ extern int HPCC_settbl(fftw_complex *w, int n);
 extern int HPCC_factor235(int n, int *ip);
 extern int HPCC_factor235_8(s64Int_t n, int *ip);
 
+/* SIMD butterflies of HPCC_fft235 (see fft235simd.c); a NULL entry selects the scalar code */
+#define HPCC_FFT_KERNEL_VARIANTS 3
+typedef struct {
+  char *name;
+  int (*fft2)(fftw_complex *a, fftw_complex *b, int m);
+  int (*fft3)(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l);
+  int (*fft4)(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l);
+  int (*fft5)(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l);
+  int (*fft8)(fftw_complex *a, fftw_complex *b, fftw_complex *w, int m, int l);
+} HPCC_FFTKernels;
+
+extern HPCC_FFTKernels HPCC_FFTKernelVariants[HPCC_FFT_KERNEL_VARIANTS];
+extern int HPCC_FFTKernelsAvailable(int v);
+extern int HPCC_fft235_kernels(int kernels);
+
 extern int HPCC_bcnrand(u64Int_t n, u64Int_t a, void *x);
 
 #define ARR2D(a, i, j, lda) a[(i)+(j)*(lda)]
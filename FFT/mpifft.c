@@ -10,10 +10,10 @@
 double *HPCC_fft_timings_forward, *HPCC_fft_timings_backward;
 
 static void
-MPIFFT0(HPCC_Params *params, int doIO, FILE *outFile, MPI_Comm comm, int locN,
+MPIFFT0(HPCC_Params *params, int doIO, FILE *outFile, MPI_Comm comm, s64Int_t n,
         double *UGflops, s64Int_t *Un, double *UmaxErr, int *Ufailure) {
-  int commRank, commSize, failure, flags;
-  s64Int_t i, n;
+  int commRank, commSize, failure, flags, kernels, transposes, py = 1, pz = 1;
+  s64Int_t i;
   s64Int_t locn, loc0, alocn, aloc0, tls;
   double maxErr, tmp1, tmp2, tmp3, t0, t1, t2, t3, Gflops;
   double deps;
@@ -33,13 +33,6 @@ MPIFFT0(HPCC_Params *params, int doIO, FILE *outFile, MPI_Comm comm, int locN,
   MPI_Comm_size( comm, &commSize );
   MPI_Comm_rank( comm, &commRank );
 
-  n = locN;
-
-  /* number of processes have been factored out - need to put it back in */
-  n *= commSize;
-
-  n *= commSize; /* global vector size */
-
 #ifdef USING_FFTW
   /* FFTW ver. 2 only supports vector sizes that fit in 'int' */
   if (n > (1<<30)-1+(1<<30)) {
@@ -53,18 +46,44 @@ MPIFFT0(HPCC_Params *params, int doIO, FILE *outFile, MPI_Comm comm, int locN,
   }
 #endif
 
+  kernels = HPCC_fft235_kernels( params->FFTKernels );
+  params->FFTKernelsUsed = kernels;
+
 #ifdef HPCC_FFTW_ESTIMATE
   flags = FFTW_ESTIMATE;
 #else
   flags = FFTW_MEASURE;
 #endif
 
+  flags |= HPCC_fftw_wisdom( params->FFTWisdom, 0 == commRank );
+
+  /* the built-in plans may overlap their transposes with the transforms or use a pencil
+     decomposition */
+  transposes = params->MPIFFTPipeline ? HPCC_FFTW_PIPELINE : 0;
+  transposes |= params->MPIFFTPencil ? HPCC_FFTW_PENCIL : 0;
+#ifndef USING_FFTW
+  flags |= transposes;
+#endif
+
   t1 = -MPI_Wtime();
   p = fftw_mpi_create_plan( comm, n, FFTW_FORWARD, flags );
   t1 += MPI_Wtime();
 
   if (! p) goto no_plan;
 
+  HPCC_fftw_export_wisdom();
+
+  /* the plan may have fallen back to other transposes than requested */
+#ifdef USING_FFTW
+  transposes = 0;
+#else
+  transposes = p->flags & (HPCC_FFTW_PIPELINE | HPCC_FFTW_PENCIL);
+  py = p->py;
+  pz = p->pz;
+#endif
+  params->MPIFFTPipelineUsed = (transposes & HPCC_FFTW_PIPELINE) != 0;
+  params->MPIFFTPencilUsed = (transposes & HPCC_FFTW_PENCIL) != 0;
+
 #ifdef USING_FFTW
   fftw_mpi_local_sizes( p, &ilocn, &iloc0, &ialocn, &ialoc0, &itls );
   locn = ilocn;
@@ -108,7 +127,7 @@ MPIFFT0(HPCC_Params *params, int doIO, FILE *outFile, MPI_Comm comm, int locN,
 
   fftw_mpi_destroy_plan( p );
 
-  ip = HPCC_fftw_mpi_create_plan( comm, n, FFTW_BACKWARD, FFTW_ESTIMATE );
+  ip = HPCC_fftw_mpi_create_plan( comm, n, FFTW_BACKWARD, FFTW_ESTIMATE | transposes );
 
   if (ip) {
     t3 = -MPI_Wtime();
@@ -136,6 +155,11 @@ MPIFFT0(HPCC_Params *params, int doIO, FILE *outFile, MPI_Comm comm, int locN,
   if (doIO) {
     fprintf( outFile, "Number of nodes: %d\n", commSize );
     fprintf( outFile, "Vector size: %20.0f\n", tmp1 = (double)n );
+    fprintf( outFile, "Kernels: %s\n", HPCC_FFTKernelVariants[kernels - 1].name );
+    if (transposes & HPCC_FFTW_PENCIL)
+      fprintf( outFile, "Transposes: pencil %dx%d\n", py, pz );
+    else
+      fprintf( outFile, "Transposes: %s\n", transposes ? "pipelined" : "MPI_Alltoall" );
     fprintf( outFile, "Generation time: %9.3f\n", t0 );
     fprintf( outFile, "Tuning: %9.3f\n", t1 );
     fprintf( outFile, "Computing: %9.3f\n", t2 );
@@ -157,10 +181,40 @@ MPIFFT0(HPCC_Params *params, int doIO, FILE *outFile, MPI_Comm comm, int locN,
   *Ufailure = failure;
 }
 
+/* The global vector size for `procCnt' processes, 0 if none fits: n/procCnt elements per process
+   and n a multiple of procCnt squared or, with pencils, of lcm(py, pz) cubed */
+static s64Int_t
+MPIFFTSize(HPCC_Params *params, int procCnt, int pow2) {
+  int f[3], locN;
+  s64Int_t q, l = 0;
+
+#ifndef USING_FFTW
+  if (params->MPIFFTPencil)
+    l = HPCC_fftw_mpi_pencils( procCnt, NULL, NULL );
+#endif
+
+  if (! l) {
+    locN = HPCC_LocalVectorSize( params, 4*procCnt, sizeof(fftw_complex), pow2 );
+    for ( ; locN >= 1 && HPCC_factor235( locN, f ); locN--)
+      ; /* EMPTY */
+    return (s64Int_t)locN * procCnt * procCnt;
+  }
+
+  /* the local size has to be a multiple of q */
+  for (q = 1; q * procCnt % (l * l * l); ++q)
+    ; /* EMPTY */
+
+  locN = HPCC_LocalVectorSize( params, 4, sizeof(fftw_complex), pow2 );
+  for (locN -= locN % q; locN >= q && HPCC_factor235( locN, f ); locN -= q)
+    ; /* EMPTY */
+
+  return locN < q ? 0 : (s64Int_t)locN * procCnt;
+}
+
 int
 HPCC_MPIFFT(HPCC_Params *params) {
   int commRank, commSize;
-  int locN, procCnt, isComputing, doIO, failure = 0;
+  int procCnt, isComputing, doIO, failure = 0;
   s64Int_t n;
   double Gflops = -1.0, maxErr = -1.0;
   MPI_Comm comm;
@@ -184,11 +238,13 @@ HPCC_MPIFFT(HPCC_Params *params) {
   as big as square of number of processes. The square is calculated
   in each factor independently. In other words, 'n' has to have
   at least twice as many 2 factors as the process count, twice as many
-  3 factors and twice as many 5 factors.
+  3 factors and twice as many 5 factors. The pencil decomposition over
+  a py by pz grid needs three times as many factors as lcm(py, pz)
+  instead (MPIFFTSize()).
   */
 
 #ifdef HPCC_FFT_235
-  locN = 0; procCnt = commSize + 1;
+  n = 0; procCnt = commSize + 1;
   do {
     int f[3];
 
@@ -198,10 +254,8 @@ HPCC_MPIFFT(HPCC_Params *params) {
       ; /* EMPTY */
 
     /* Make sure the local vector size is greater than 0 */
-    locN = HPCC_LocalVectorSize( params, 4*procCnt, sizeof(fftw_complex), 0 );
-    for ( ; locN >= 1 && HPCC_factor235( locN, f ); locN--)
-      ; /* EMPTY */
-  } while (locN < 1);
+    n = MPIFFTSize( params, procCnt, 0 );
+  } while (n < 1);
 #else
   /* Find power of two that is smaller or equal to number of processes */
   for (procCnt = 1; procCnt <= (commSize >> 1); procCnt <<= 1)
@@ -209,8 +263,8 @@ HPCC_MPIFFT(HPCC_Params *params) {
 
   /* Make sure the local vector size is greater than 0 */
   while (1) {
-    locN = HPCC_LocalVectorSize( params, 4*procCnt, sizeof(fftw_complex), 1 );
-    if (locN) break;
+    n = MPIFFTSize( params, procCnt, 1 );
+    if (n) break;
     procCnt >>= 1;
   }
 #endif
@@ -226,7 +280,7 @@ HPCC_MPIFFT(HPCC_Params *params) {
     MPI_Comm_split( MPI_COMM_WORLD, isComputing ? 0 : MPI_UNDEFINED, commRank, &comm );
 
   if (isComputing)
-    MPIFFT0( params, doIO, outFile, comm, locN, &Gflops, &n, &maxErr, &failure );
+    MPIFFT0( params, doIO, outFile, comm, n, &Gflops, &n, &maxErr, &failure );
 
   if (commSize != procCnt && isComputing && comm != MPI_COMM_NULL)
     MPI_Comm_free( &comm );
@@ -7,7 +7,7 @@ HPCC_StarFFT(HPCC_Params *params) {
   int commRank, commSize;
   int rv, errCount, failure = 0, failureAll = 0;
   double localGflops, minGflops, maxGflops, avgGflops;
-  int n;
+  int n, threads;
   FILE *outputFile;
   MPI_Comm comm = MPI_COMM_WORLD;
 
@@ -16,8 +16,9 @@ HPCC_StarFFT(HPCC_Params *params) {
   MPI_Comm_size( comm, &commSize );
   MPI_Comm_rank( comm, &commRank );
 
-  rv = HPCC_TestFFT( params, 0 == commRank, &localGflops, &n, &failure );
+  rv = HPCC_TestFFT( params, 0 == commRank, &localGflops, &n, &threads, &failure );
   params->FFT_N = n;
+  params->StarFFTThreads = threads;
 
   MPI_Reduce( &rv, &errCount, 1, MPI_INT, MPI_SUM, 0, comm );
   MPI_Allreduce( &failure, &failureAll, 1, MPI_INT, MPI_MAX, comm );
@@ -44,7 +45,7 @@ int
 HPCC_SingleFFT(HPCC_Params *params) {
   int commRank, commSize;
   int rv, errCount, rank, failure = 0;
-  int n;
+  int n, threads = 1;
   double localGflops;
   double scl = 1.0 / RAND_MAX;
   FILE *outputFile;
@@ -69,7 +70,7 @@ HPCC_SingleFFT(HPCC_Params *params) {
   MPI_Bcast( &rank, 1, MPI_INT, 0, comm ); /* broadcast the rank selected on node 0 */
 
   if (commRank == rank) /* if this node has been selected */
-    rv = HPCC_TestFFT( params, 0 == commRank, &localGflops, &n, &failure );
+    rv = HPCC_TestFFT( params, 0 == commRank, &localGflops, &n, &threads, &failure );
 
   MPI_Bcast( &rv, 1, MPI_INT, rank, comm ); /* broadcast error code */
   errCount = rv;
@@ -79,6 +80,8 @@ HPCC_SingleFFT(HPCC_Params *params) {
   /* broadcast results */
   MPI_Bcast( &localGflops, 1, MPI_DOUBLE, rank, comm );
   params->SingleFFTGflops = localGflops;
+  MPI_Bcast( &threads, 1, MPI_INT, rank, comm );
+  params->SingleFFTThreads = threads;
 
   BEGIN_IO( commRank, params->outFname, outputFile);
   fprintf( outputFile, "Node(s) with error %d\n", errCount );
@@ -95,45 +95,69 @@ pztrans(fftw_complex *a, fftw_complex *b, s64Int_t nn, hpcc_fftw_mpi_plan p, int
     MPI_Alltoall( a, nn2, p->cmplx, b, nn2, p->cmplx, p->comm );
 }	/* pztrans */
 
+/*
+  The pipelined transposes (HPCC_FFTW_PIPELINE) replace MPI_Alltoall with one
+  message per pair of processes, so that every chunk of nn2 elements is sent
+  as soon as it is ready and, in the transpose between the transforms along z
+  and y, transformed as soon as it arrived. p->req holds the receives from
+  and then the sends to every process; the chunk of the calling process is
+  never sent.
+ */
+#define PIPE_MIDDLE 1
+#define PIPE_LAST   2
+
 static void
-pzfft1d0(fftw_complex *a, fftw_complex *a2, fftw_complex *apxyz, fftw_complex *axyzp, fftw_complex *b,
-  fftw_complex *bxyzp, fftw_complex *bzyx, fftw_complex *cy, fftw_complex *cz, fftw_complex *d,
-  fftw_complex *wx, fftw_complex *wy, fftw_complex *wz, fftw_complex *ww, fftw_complex *www,
-  int nx, int ny, int nz, hpcc_fftw_mpi_plan p, int npu, const int *lnx, const int *lny, const int *lnz) {
+pzirecv(fftw_complex *b, int nn2, hpcc_fftw_mpi_plan p, int me, int npu) {
+  int l;
 
-  int i, j, k, l, ii, jj, kk;
-  int tmin1, tmin2, tmin3;
-  int nnx, nnz;
-  s64Int_t nn;
-  int ldcz, lda2_1, lda2_2, ldaxyzp1, ldaxyzp2, ldaxyzp3, ldbxyzp1, ldbxyzp2, ldbxyzp3, ldww, ldcy;
-  int ldwww1, ldwww2, ldwww3, ldapxyz1, ldapxyz2, ldapxyz3, ldbzyx1, ldbzyx2, lda1, lda2;
-  fftw_complex ztmp1, ztmp2, ztmp3;
+  for (l = 0; l < npu; ++l)
+    if (l == me)
+      p->req[l] = MPI_REQUEST_NULL;
+    else
+      MPI_Irecv( b + (s64Int_t)l * nn2, nn2, p->cmplx, l, 0, p->comm, p->req + l );
+}	/* pzirecv */
+
+static void
+pzisend(fftw_complex *a, int nn2, int l, hpcc_fftw_mpi_plan p, int me, int npu) {
+  if (l == me)
+    p->req[npu + l] = MPI_REQUEST_NULL;
+  else
+    MPI_Isend( a + (s64Int_t)l * nn2, nn2, p->cmplx, l, 0, p->comm, p->req + npu + l );
+}	/* pzisend */
+
+/* Stores row `l' of `a' (an npu by nn2 matrix) in chunk `l' of `b': one chunk of ztrans( a, b, npu, nn2 ) */
+static void
+pzgather(fftw_complex *a, fftw_complex *b, int l, int nn2, int npu) {
+  int j;
+
+  b += (s64Int_t)l * nn2;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (j = 0; j < nn2; ++j) {
+    c_assgn( b[j], a[l + (s64Int_t)npu * j] );
+  }
+}	/* pzgather */
+
+/* Transforms the x pencils of `a2' (nnx by ny by nz) along z and stores them in `axyzp' as `nc'
+   chunks: chunk l holds kz = l, l + nc, l + 2*nc, ... */
+static void
+pzfftz(fftw_complex *a2, fftw_complex *axyzp, fftw_complex *cz, fftw_complex *d, fftw_complex *wz,
+  int nnx, int ny, int nz, int nc, const int *lnz) {
+
+  int i, j, k, l, ii, kk;
+  int tmin1, tmin2;
+  int ldcz, lda2_1, lda2_2, ldaxyzp1, ldaxyzp2, ldaxyzp3, nnz;
 
   ldcz = nz + FFTE_NP;
-  lda2_1 = nx / npu;
+  lda2_1 = nnx;
   lda2_2 = ny;
-  ldaxyzp1 = nx / npu;
+  ldaxyzp1 = nnx;
   ldaxyzp2 = ny;
-  ldaxyzp3 = nz / npu;
-  ldbxyzp1 = nx / npu;
-  ldbxyzp2 = ny;
-  ldbxyzp3 = nz / npu;
-  ldww = ny;
-  ldcy = ny + FFTE_NP;
-  ldwww1 = npu;
-  ldwww2 = nx / npu;
-  ldwww3 = ny;
-  ldapxyz1 = npu;
-  ldapxyz2 = nx / npu;
-  ldapxyz3 = ny;
-  ldbzyx1 = nz / npu;
-  ldbzyx2 = ny;
-  lda1 = nx;
-  lda2 = ny;
+  ldaxyzp3 = nz / nc;
 
-  nnx = nx / npu;
-  nnz = nz / npu;
-  nn = (s64Int_t)nx * ny * nz / npu;
+  nnz = nz / nc;
 
 #ifdef _OPENMP
 #pragma omp for private(i,k,l,ii,kk,tmin1,tmin2)
@@ -156,96 +180,464 @@ pzfft1d0(fftw_complex *a, fftw_complex *a2, fftw_complex *apxyz, fftw_complex *a
       for (i = ii; i < tmin2; ++i)
         HPCC_fft235( PTR2D( cz, 0, i-ii, ldcz ), d, wz, nz, lnz );
 
-      for (l = 0; l < npu; ++l) {
+      for (l = 0; l < nc; ++l) {
         for (k = 0; k < nnz; ++k) {
 
           /* reusing tmin2 from above */
           for (i = ii; i < tmin2; ++i) {
             c_assgn( ARR4D( axyzp, i, j, k, l, ldaxyzp1, ldaxyzp2, ldaxyzp3 ),
-                     ARR2D( cz, l + k*npu, i-ii, ldcz ) );
+                     ARR2D( cz, l + k*nc, i-ii, ldcz ) );
           }
         }
       }
     }
   }
+}	/* pzfftz */
+
+/* Transforms chunk `l' of plane `k' along y between the twiddle factors `ww' and `www' */
+static void
+pzffty(fftw_complex *bxyzp, fftw_complex *apxyz, fftw_complex *cy, fftw_complex *d, fftw_complex *wy,
+  fftw_complex *ww, fftw_complex *www, int nx, int ny, int nz, int npu, int k, int l, const int *lny) {
+
+  int i, j, ii, jj;
+  int tmin1, tmin2;
+  int nnx;
+  int ldbxyzp1, ldbxyzp2, ldbxyzp3, ldww, ldcy, ldwww1, ldwww2, ldwww3, ldapxyz1, ldapxyz2, ldapxyz3;
+  fftw_complex ztmp1, ztmp2, ztmp3;
+
+  ldbxyzp1 = nx / npu;
+  ldbxyzp2 = ny;
+  ldbxyzp3 = nz / npu;
+  ldww = ny;
+  ldcy = ny + FFTE_NP;
+  ldwww1 = npu;
+  ldwww2 = nx / npu;
+  ldwww3 = ny;
+  ldapxyz1 = npu;
+  ldapxyz2 = nx / npu;
+  ldapxyz3 = ny;
+
+  nnx = nx / npu;
+
+  for (ii = 0; ii < nnx; ii += FFTE_NBLK) {
+    for (jj = 0; jj < ny; jj += FFTE_NBLK) {
+
+      V3MIN( tmin1, ii + FFTE_NBLK, nnx );
+      for (i = ii; i < tmin1; ++i) {
+
+        V3MIN( tmin2, jj + FFTE_NBLK, ny );
+        for (j = jj; j < tmin2; ++j) {
+          c_assgn( ztmp1, ARR4D( bxyzp, i, j, k, l, ldbxyzp1, ldbxyzp2, ldbxyzp3 ) );
+          c_assgn( ztmp2, ARR2D( ww, j, k, ldww ) );
+          c_mul3v(ztmp3, ztmp1, ztmp2);
+          c_assgn( ARR2D( cy, j, i-ii, ldcy ), ztmp3 );
+        }
+      }
+    }
+
+    V3MIN( tmin1, ii + FFTE_NBLK, nnx );
+    for (i = ii; i < tmin1; ++i)
+      HPCC_fft235( PTR2D( cy, 0, i-ii, ldcy ), d, wy, ny, lny );
+
+    for (j = 0; j < ny; ++j) {
+    V3MIN( tmin1, ii + FFTE_NBLK, nnx );
+      for (i = ii; i < tmin1; ++i) {
+        c_assgn( ztmp1, ARR2D( cy, j, i-ii, ldcy ) );
+        c_assgn( ztmp2, ARR4D( www, l, i, j, k, ldwww1, ldwww2, ldwww3 ) );
+        c_mul3v(ztmp3, ztmp1, ztmp2);
+        c_assgn( ARR4D( apxyz, l, i, j, k, ldapxyz1, ldapxyz2, ldapxyz3 ), ztmp3 );
+      }
+    }
+  }
+}	/* pzffty */
+
+/* With PIPE_MIDDLE `apxyz' may not be `axyzp' (it is written while `axyzp' is being sent) and with
+   PIPE_LAST the chunks of `bzyx' are sent to `axyzp' */
+static void
+pzfft1d0(fftw_complex *a2, fftw_complex *apxyz, fftw_complex *axyzp, fftw_complex *bxyzp, fftw_complex *bzyx,
+  fftw_complex *cy, fftw_complex *cz, fftw_complex *d,
+  fftw_complex *wx, fftw_complex *wy, fftw_complex *wz, fftw_complex *ww, fftw_complex *www,
+  int nx, int ny, int nz, hpcc_fftw_mpi_plan p, int me, int npu, int pipe,
+  const int *lnx, const int *lny, const int *lnz) {
+
+  int i, j, k, l, m, ii, jj, kk, lo, hi;
+  int tmin1, tmin2, tmin3;
+  int nnx, nnz, nn2;
+  s64Int_t nn;
+  int ldbzyx1, ldbzyx2, lda1, lda2;
 
+  ldbzyx1 = nz / npu;
+  ldbzyx2 = ny;
+  lda1 = nx;
+  lda2 = ny;
+
+  nnx = nx / npu;
+  nnz = nz / npu;
+  nn = (s64Int_t)nx * ny * nz / npu;
+  nn2 = nn / npu;
+
+  pzfftz( a2, axyzp, cz, d, wz, nnx, ny, nz, npu, lnz );
+
+  if (pipe & PIPE_MIDDLE) {
 #ifdef _OPENMP
 #pragma omp single
-  {
+    {
 #endif
-  p->timings[3] = MPI_Wtime();
+    p->timings[3] = MPI_Wtime();
 
-  pztrans( a, b, nn, p, npu );
+    pzirecv( bxyzp, nn2, p, me, npu );
+    for (l = 0; l < npu; ++l)
+      pzisend( axyzp, nn2, l, p, me, npu );
+#ifdef _OPENMP
+    }
+#endif
 
-  p->timings[4] = MPI_Wtime();
+    /* the own chunk is transformed first, the others in the order in which they arrive */
+    for (m = 0; m < npu; ++m) {
 #ifdef _OPENMP
+#pragma omp single copyprivate(l)
+      {
+#endif
+      if (m)
+        MPI_Waitany( npu, p->req, &l, MPI_STATUS_IGNORE );
+      else
+        l = me;
+#ifdef _OPENMP
+      }
+#endif
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
+      for (k = 0; k < nnz; ++k)
+        pzffty( l == me ? axyzp : bxyzp, apxyz, cy, d, wy, ww, www, nx, ny, nz, npu, k, l, lny );
+    }
+
+#ifdef _OPENMP
+#pragma omp single nowait
+    {
+#endif
+    MPI_Waitall( npu, p->req + npu, MPI_STATUSES_IGNORE );
+
+    p->timings[4] = MPI_Wtime();
+#ifdef _OPENMP
+    }
+#endif
+
+#ifdef _OPENMP
+#pragma omp for private(j)
+#endif
+    for (k = 0; k < nnz; ++k)
+      for (j = 0; j < ny; ++j)
+        HPCC_fft235( PTR3D( apxyz, 0, j, k, lda1, lda2 ), d, wx, nx, lnx );
+
+  } else {
+#ifdef _OPENMP
+#pragma omp single
+    {
+#endif
+    p->timings[3] = MPI_Wtime();
+
+    pztrans( axyzp, bxyzp, nn, p, npu );
+
+    p->timings[4] = MPI_Wtime();
+#ifdef _OPENMP
+    }
+#endif
+
+#ifdef _OPENMP
+#pragma omp for private(j,l)
+#endif
+    for (k = 0; k < nnz; ++k) {
+      for (l = 0; l < npu; ++l)
+        pzffty( bxyzp, apxyz, cy, d, wy, ww, www, nx, ny, nz, npu, k, l, lny );
+
+      for (j = 0; j < ny; ++j)
+        HPCC_fft235( PTR3D( apxyz, 0, j, k, lda1, lda2 ), d, wx, nx, lnx );
+    }
   }
+
+  if (pipe & PIPE_LAST) {
+#ifdef _OPENMP
+#pragma omp single
 #endif
+    pzirecv( axyzp, nn2, p, me, npu );
+  }
+
+  /* chunk `m' of `bzyx' holds the `nnx' rows from m*nnx on and is sent as soon as it is complete */
+  for (m = 0; m < (pipe & PIPE_LAST ? npu : 1); ++m) {
+    lo = pipe & PIPE_LAST ? m * nnx : 0;
+    hi = pipe & PIPE_LAST ? lo + nnx : nx;
 
 #ifdef _OPENMP
-#pragma omp for private(i,j,l,ii,jj,kk,tmin1,tmin2)
+#pragma omp for private(i,j,k,jj,kk,tmin1,tmin2,tmin3)
 #endif
-  for (k = 0; k < nnz; ++k) {
-    for (l = 0; l < npu; ++l) {
-      for (ii = 0; ii < nnx; ii += FFTE_NBLK) {
-        for (jj = 0; jj < ny; jj += FFTE_NBLK) {
+    for (ii = lo; ii < hi; ii += FFTE_NBLK) {
+      for (jj = 0; jj < ny; jj += FFTE_NBLK) {
+        for (kk = 0; kk < nnz; kk += FFTE_NBLK) {
 
-          V3MIN( tmin1, ii + FFTE_NBLK, nnx );
+          V3MIN( tmin1, ii + FFTE_NBLK, hi );
           for (i = ii; i < tmin1; ++i) {
 
             V3MIN( tmin2, jj + FFTE_NBLK, ny );
             for (j = jj; j < tmin2; ++j) {
-              c_assgn( ztmp1, ARR4D( bxyzp, i, j, k, l, ldbxyzp1, ldbxyzp2, ldbxyzp3 ) );
-              c_assgn( ztmp2, ARR2D( ww, j, k, ldww ) );
-              c_mul3v(ztmp3, ztmp1, ztmp2);
-              c_assgn( ARR2D( cy, j, i-ii, ldcy ), ztmp3 );
+
+              V3MIN( tmin3, kk + FFTE_NBLK, nnz );
+              for (k = kk; k < tmin3; ++k) {
+                c_assgn( ARR3D( bzyx, k, j, i, ldbzyx1, ldbzyx2 ), ARR3D( apxyz, i, j, k, lda1, lda2 ) );
+              }
             }
           }
         }
+      }
+    }
 
-        V3MIN( tmin1, ii + FFTE_NBLK, nnx );
-        for (i = ii; i < tmin1; ++i)
-          HPCC_fft235( PTR2D( cy, 0, i-ii, ldcy ), d, wy, ny, lny );
+    if (pipe & PIPE_LAST) {
+#ifdef _OPENMP
+#pragma omp single nowait
+#endif
+      pzisend( bzyx, nn2, m, p, me, npu );
+    }
+  }
+}	/* pzfft1d0 */
 
-        for (j = 0; j < ny; ++j) {
-        V3MIN( tmin1, ii + FFTE_NBLK, nnx );
-          for (i = ii; i < tmin1; ++i) {
-            c_assgn( ztmp1, ARR2D( cy, j, i-ii, ldcy ) );
-            c_assgn( ztmp2, ARR4D( www, l, i, j, k, ldwww1, ldwww2, ldwww3 ) );
-            c_mul3v(ztmp3, ztmp1, ztmp2);
-            c_assgn( ARR4D( apxyz, l, i, j, k, ldapxyz1, ldapxyz2, ldapxyz3 ), ztmp3 );
-          }
-        }
+/*
+  Pencil decomposition: the npu = py*pz processes form a py by pz grid and
+  process me = iz + pz*iy talks to the py processes of its column (p->commy,
+  same iz) and the pz processes of its row (p->commz, same iy) only. Each of
+  nx, ny and nz has to be a multiple of lcm(py, pz) instead of nx and nz being
+  multiples of npu, so n only needs to be a multiple of lcm(py, pz) cubed.
+
+  - pzpencilin spreads jx over the row and jy over the column: the process
+    holds the z pencils of jx = iz + pz*i and jy = iy + py*j and transforms
+    them along z.
+  - An all-to-all in p->commy swaps jy for kz = iy + py*k. The y pencils are
+    transformed along y.
+  - An all-to-all in p->commz swaps jx for ky = iz + pz*j. The x pencils are
+    transformed along x.
+  - pzpencilout swaps kz for the nx/py values of kx of the column and then
+    ky for kz = iz + pz*k, which leaves the row with a contiguous part of the
+    result to be spread over it.
+ */
+
+/* From the BLOCK distribution of `a' to the z pencils in `a' (nx/pz by ny/py by nz), through `b' */
+static void
+pzpencilin(fftw_complex *a, fftw_complex *b, int nx, int ny, int nz, hpcc_fftw_mpi_plan p) {
+  int i, j, k, l, m, py, pz, nxz, nyy, nzy;
+  s64Int_t nn;
+
+  py = p->py;
+  pz = p->pz;
+  nxz = nx / pz;
+  nyy = ny / py;
+  nzy = nz / py;
+  nn = (s64Int_t)nx * ny * nz / (py * pz);
+
+  /* the row holds the nz/py planes of z from iy*nz/py on; every process of it gets jx = iz + pz*i */
+  ztrans( a, b, pz, nn / pz );
+  MPI_Alltoall( b, nn / pz, p->cmplx, a, nn / pz, p->cmplx, p->commz );
+
+  /* chunk l gets jy = l + py*j; process l of the column puts it in its planes from l*nz/py on */
+#ifdef _OPENMP
+#pragma omp parallel for private(i,j,k,l)
+#endif
+  for (m = 0; m < py * nzy; ++m) {
+    k = m / py;
+    l = m % py;
+    for (j = 0; j < nyy; ++j)
+      for (i = 0; i < nxz; ++i) {
+        c_assgn( ARR4D( b, i, j, k, l, nxz, nyy, nzy ), ARR3D( a, i, l + py*j, k, nxz, ny ) );
       }
-    }
+  }
 
-    for (j = 0; j < ny; ++j)
-      HPCC_fft235( PTR3D( a, 0, j, k, lda1, lda2 ), d, wx, nx, lnx );
+  MPI_Alltoall( b, nn / py, p->cmplx, a, nn / py, p->cmplx, p->commy );
+}	/* pzpencilin */
+
+/* Transforms the y pencils of plane `k' for i = ii, ..., ii + FFTE_NBLK - 1; chunk l of `bxyzp' holds
+   jy = l + py*j and chunk s of `apxyz' gets ky = s + pz*j */
+static void
+pzffty2(fftw_complex *bxyzp, fftw_complex *apxyz, fftw_complex *cy, fftw_complex *d, fftw_complex *wy,
+  fftw_complex *ww, fftw_complex *www, int nx, int ny, int nz, int py, int pz, int k, int ii,
+  const int *lny) {
+
+  int i, j, l, s;
+  int tmin1;
+  int nxz, nyy, nyz, nzy, ldcy;
+  fftw_complex ztmp1, ztmp2, ztmp3;
+
+  nxz = nx / pz;
+  nyy = ny / py;
+  nyz = ny / pz;
+  nzy = nz / py;
+  ldcy = ny + FFTE_NP;
+
+  V3MIN( tmin1, ii + FFTE_NBLK, nxz );
+
+  for (l = 0; l < py; ++l)
+    for (j = 0; j < nyy; ++j)
+      for (i = ii; i < tmin1; ++i) {
+        c_assgn( ztmp1, ARR4D( bxyzp, i, j, k, l, nxz, nyy, nzy ) );
+        c_assgn( ztmp2, ARR2D( ww, l + py*j, k, ny ) );
+        c_mul3v(ztmp3, ztmp1, ztmp2);
+        c_assgn( ARR2D( cy, l + py*j, i-ii, ldcy ), ztmp3 );
+      }
+
+  for (i = ii; i < tmin1; ++i)
+    HPCC_fft235( PTR2D( cy, 0, i-ii, ldcy ), d, wy, ny, lny );
+
+  for (s = 0; s < pz; ++s)
+    for (j = 0; j < nyz; ++j)
+      for (i = ii; i < tmin1; ++i) {
+        c_assgn( ztmp1, ARR2D( cy, s + pz*j, i-ii, ldcy ) );
+        c_assgn( ztmp2, ARR4D( www, i, j, k, s, nxz, nyz, nzy ) );
+        c_mul3v(ztmp3, ztmp1, ztmp2);
+        c_assgn( ARR4D( apxyz, i, j, k, s, nxz, nyz, nzy ), ztmp3 );
+      }
+}	/* pzffty2 */
+
+/* Transforms the x pencils of ky = iz + pz*j for k = kk, ..., kk + FFTE_NBLK - 1; chunk s of `bpxyz'
+   holds jx = s + pz*i and chunk l of `bzyx' gets the nx/py values of kx from l*nx/py on */
+static void
+pzfftx2(fftw_complex *bpxyz, fftw_complex *bzyx, fftw_complex *cx, fftw_complex *d, fftw_complex *wx,
+  int nx, int ny, int nz, int py, int pz, int j, int kk, const int *lnx) {
+
+  int i, k, l, s;
+  int tmin1;
+  int nxy, nxz, nyz, nzy, ldcx;
+
+  nxy = nx / py;
+  nxz = nx / pz;
+  nyz = ny / pz;
+  nzy = nz / py;
+  ldcx = nx + FFTE_NP;
+
+  V3MIN( tmin1, kk + FFTE_NBLK, nzy );
+
+  for (s = 0; s < pz; ++s)
+    for (k = kk; k < tmin1; ++k)
+      for (i = 0; i < nxz; ++i) {
+        c_assgn( ARR2D( cx, s + pz*i, k-kk, ldcx ), ARR4D( bpxyz, i, j, k, s, nxz, nyz, nzy ) );
+      }
+
+  for (k = kk; k < tmin1; ++k)
+    HPCC_fft235( PTR2D( cx, 0, k-kk, ldcx ), d, wx, nx, lnx );
+
+  for (l = 0; l < py; ++l)
+    for (i = 0; i < nxy; ++i)
+      for (k = kk; k < tmin1; ++k) {
+        c_assgn( ARR4D( bzyx, k, j, i, l, nzy, nyz, nxy ), ARR2D( cx, l*nxy + i, k-kk, ldcx ) );
+      }
+}	/* pzfftx2 */
+
+/* The pencil counterpart of pzfft1d0: from the z pencils in `a' to the x pencils in `b' */
+static void
+pzfft1d0p(fftw_complex *a, fftw_complex *b, fftw_complex *c, fftw_complex *d,
+  fftw_complex *wx, fftw_complex *wy, fftw_complex *wz, fftw_complex *ww, fftw_complex *www,
+  int nx, int ny, int nz, hpcc_fftw_mpi_plan p, const int *lnx, const int *lny, const int *lnz) {
+
+  int j, k, m, py, pz, nb;
+  s64Int_t nn;
+  double t;
+
+  py = p->py;
+  pz = p->pz;
+  nn = (s64Int_t)nx * ny * nz / (py * pz);
+
+  pzfftz( a, b, c, d, wz, nx / pz, ny / py, nz, py, lnz );
+
+  /* timings[3] is set so that timings[4] - timings[3] is the time of both all-to-alls */
+#ifdef _OPENMP
+#pragma omp single
+  {
+#endif
+  t = MPI_Wtime();
+  MPI_Alltoall( b, nn / py, p->cmplx, a, nn / py, p->cmplx, p->commy );
+  p->timings[3] = MPI_Wtime() - t;
+#ifdef _OPENMP
   }
+#endif
+
+  nb = (nx / pz + FFTE_NBLK - 1) / FFTE_NBLK;
 
 #ifdef _OPENMP
-#pragma omp for private(i,j,k,jj,kk,tmin1,tmin2,tmin3)
+#pragma omp for private(k)
 #endif
-  for (ii = 0; ii < nx; ii += FFTE_NBLK) {
-    for (jj = 0; jj < ny; jj += FFTE_NBLK) {
-      for (kk = 0; kk < nnz; kk += FFTE_NBLK) {
+  for (m = 0; m < nz / py * nb; ++m) {
+    k = m / nb;
+    pzffty2( a, b, c, d, wy, ww, www, nx, ny, nz, py, pz, k, m % nb * FFTE_NBLK, lny );
+  }
 
-        V3MIN( tmin1, ii + FFTE_NBLK, nx );
-        for (i = ii; i < tmin1; ++i) {
+#ifdef _OPENMP
+#pragma omp single
+  {
+#endif
+  t = MPI_Wtime();
+  MPI_Alltoall( b, nn / pz, p->cmplx, a, nn / pz, p->cmplx, p->commz );
+  p->timings[4] = MPI_Wtime();
+  p->timings[3] = t - p->timings[3];
+#ifdef _OPENMP
+  }
+#endif
 
-          V3MIN( tmin2, jj + FFTE_NBLK, ny );
-          for (j = jj; j < tmin2; ++j) {
+  nb = (nz / py + FFTE_NBLK - 1) / FFTE_NBLK;
 
-            V3MIN( tmin3, kk + FFTE_NBLK, nnz );
-            for (k = kk; k < tmin3; ++k) {
-              c_assgn( ARR3D( bzyx, k, j, i, ldbzyx1, ldbzyx2 ), ARR3D( a, i, j, k, lda1, lda2 ) );
-            }
-          }
-        }
+#ifdef _OPENMP
+#pragma omp for private(j)
+#endif
+  for (m = 0; m < ny / pz * nb; ++m) {
+    j = m / nb;
+    pzfftx2( a, b, c, d, wx, nx, ny, nz, py, pz, j, m % nb * FFTE_NBLK, lnx );
+  }
+}	/* pzfft1d0p */
+
+/* From the x pencils in `b' to the BLOCK distribution of `b', through `a' */
+static void
+pzpencilout(fftw_complex *b, fftw_complex *a, int nx, int ny, int nz, hpcc_fftw_mpi_plan p) {
+  int i, j, k, m, s, py, pz, nxy, nyz, nzy, nzz, kz;
+  s64Int_t nn;
+
+  py = p->py;
+  pz = p->pz;
+  nxy = nx / py;
+  nyz = ny / pz;
+  nzy = nz / py;
+  nzz = nz / pz;
+  nn = (s64Int_t)nx * ny * nz / (py * pz);
+
+  /* the column gets all of kz for the nx/py values of kx from iy*nx/py on */
+  MPI_Alltoall( b, nn / py, p->cmplx, a, nn / py, p->cmplx, p->commy );
+
+  /* chunk s gets kz = s + pz*k; `a' holds kz = l + py*k in chunk l */
+#ifdef _OPENMP
+#pragma omp parallel for private(i,j,k,s,kz)
+#endif
+  for (m = 0; m < nxy * nyz; ++m) {
+    i = m / nyz;
+    j = m % nyz;
+    for (s = 0; s < pz; ++s)
+      for (k = 0; k < nzz; ++k) {
+        kz = s + pz*k;
+        c_assgn( ARR4D( b, k, j, i, s, nzz, nyz, nxy ), ARR4D( a, kz / py, j, i, kz % py, nzy, nyz, nxy ) );
       }
+  }
+
+  MPI_Alltoall( b, nn / pz, p->cmplx, a, nn / pz, p->cmplx, p->commz );
+
+  /* the process holds every pz-th element of the row's part of the result, from iz on */
+#ifdef _OPENMP
+#pragma omp parallel for private(i,j,k)
+#endif
+  for (m = 0; m < nxy * ny; ++m) {
+    i = m / ny;
+    j = m % ny;
+    for (k = 0; k < nzz; ++k) {
+      c_assgn( ARR3D( b, k, j, i, nzz, ny ), ARR4D( a, k, j / pz, i, j % pz, nzz, nyz, nxy ) );
     }
   }
-}	/* pzfft1d0 */
+
+  MPI_Alltoall( b, nn / pz, p->cmplx, a, nn / pz, p->cmplx, p->commz );
+  ztrans( a, b, nn / pz, pz );
+}	/* pzpencilout */
 
 static void
 psettbl2(fftw_complex *w, int ny, int nz, int me, int npu) {
@@ -295,14 +687,42 @@ psettbl3(fftw_complex *w, int nx, int ny, int nz, int me, int npu) {
       }
 }	/* psettbl3 */
 
+/* The twiddle factors of the pencil decomposition between the transforms along y and x:
+   w(i, j, k, s) for jx = iz + pz*i, ky = s + pz*j and kz = iy + py*k */
+static void
+psettbl3p(fftw_complex *w, int nx, int ny, int nz, int iy, int iz, int py, int pz) {
+  int i, j, k, s;
+  int nxz, nyz, nzy;
+  double pi2, px, jx;
+
+  nxz = nx / pz;
+  nyz = ny / pz;
+  nzy = nz / py;
+
+  pi2 = 8.0 * atan(1.0);
+  px = -pi2 / ((double)nx * ny * nz);
+
+#ifdef _OPENMP
+#pragma omp parallel for private(i,j,k,jx)
+#endif
+  for (s = 0; s < pz; ++s)
+    for (k = 0; k < nzy; ++k)
+      for (j = 0; j < nyz; ++j)
+        for (i = 0; i < nxz; ++i) {
+          jx = iz + (double)pz * i;
+          c_re( ARR4D( w, i, j, k, s, nxz, nyz, nzy ) ) = cos( px * jx * (iy + (double)k * py + (s + (double)j * pz) * nz));
+          c_im( ARR4D( w, i, j, k, s, nxz, nyz, nzy ) ) = sin( px * jx * (iy + (double)k * py + (s + (double)j * pz) * nz));
+        }
+}	/* psettbl3p */
+
 int
 HPCC_pzfft1d(s64Int_t n, fftw_complex *a, fftw_complex *b, fftw_complex *w, int me, int npu, int iopt,
   hpcc_fftw_mpi_plan p) {
 
-  int ip[3], lnx[3], lny[3], lnz[3], lnpu[3];
+  int ip[3], lnx[3], lny[3], lnz[3], lnpu[3], lpz[3];
   s64Int_t nn;
-  int i, inn, nn2, nd, nx, ny, nz;
-  fftw_complex *wx, *wy, *wz, *c;
+  int i, inn, nn2, nd, nx, ny, nz, pipe, pencil;
+  fftw_complex *wx, *wy, *wz, *c, *a2;
   double dn;
 
   p->timings[0] = MPI_Wtime();
@@ -315,9 +735,15 @@ HPCC_pzfft1d(s64Int_t n, fftw_complex *a, fftw_complex *b, fftw_complex *w, int
   nn = n / npu; inn = (int)nn;
   nn2 = nn / npu;
 
-  HPCC_factor235( npu, lnpu );
+  /* every dimension is a multiple of lcm(py, pz): of npu for nx and nz without pencils (py = 1) */
+  HPCC_factor235( p->py, lnpu );
+  HPCC_factor235( p->pz, lpz );
   HPCC_factor235_8( n, ip );
 
+  for (i = 0; i < 3; ++i) {
+    EMAX( lnpu[i], lpz[i], lnpu[i] );
+  }
+
   for (i = 0; i < 3; ++i) {
     EMAX( lnz[i], lnpu[i], (ip[i]+1)/3 );
     EMAX( lnx[i], lnpu[i], (ip[i]-lnz[i]+1)/2 );
@@ -328,15 +754,25 @@ HPCC_pzfft1d(s64Int_t n, fftw_complex *a, fftw_complex *b, fftw_complex *w, int
   ny = HPCC_ipow( 2, lny[0] ) * HPCC_ipow( 3, lny[1] ) * HPCC_ipow( 5, lny[2] );
   nz = HPCC_ipow( 2, lnz[0] ) * HPCC_ipow( 3, lnz[1] ) * HPCC_ipow( 5, lnz[2] );
 
+  pencil = (p->flags & HPCC_FFTW_PENCIL) != 0;
+
   if (0 == iopt) {
     HPCC_settbl( wx, nx );
     HPCC_settbl( wy, ny );
     HPCC_settbl( wz, nz );
-    psettbl2( w, ny, nz, me, npu );
-    psettbl3( w + ny * (nz / npu), nx, ny, nz, me, npu );
+    if (pencil) {
+      psettbl2( w, ny, nz, me / p->pz, p->py );
+      psettbl3p( w + ny * (nz / p->py), nx, ny, nz, me / p->pz, me % p->pz, p->py, p->pz );
+    } else {
+      psettbl2( w, ny, nz, me, npu );
+      psettbl3( w + ny * (nz / npu), nx, ny, nz, me, npu );
+    }
     return 0;
   }
 
+  /* the pencil decomposition has no CYCLIC distribution */
+  if (pencil && (-2 == iopt || 2 == iopt)) return -1;
+
   if (1 == iopt || 2 == iopt) {
     for (i = 0; i < inn; ++i) {
       c_im( a[i] ) = -c_im( a[i] );
@@ -345,14 +781,32 @@ HPCC_pzfft1d(s64Int_t n, fftw_complex *a, fftw_complex *b, fftw_complex *w, int
 
   p->timings[1] = MPI_Wtime();
 
+  pipe = (p->flags & HPCC_FFTW_PIPELINE) && npu > 1 && ! pencil ? PIPE_MIDDLE : 0;
+  if (pipe && (-1 == iopt || 1 == iopt || 2 == iopt)) pipe |= PIPE_LAST;
+
+  /* the pipelined plans receive into their own buffer while the rows of `a' are being sent */
+  a2 = a;
   if (-1 == iopt || 1 == iopt || -2 == iopt) {
-    ztrans( a, b, npu, nn2 );
-    pztrans( b, a, nn, p, npu );
+    if (pencil)
+      pzpencilin( a, b, nx, ny, nz, p );
+    else if (pipe) {
+      a2 = p->buf;
+      pzirecv( a2, nn2, p, me, npu );
+      for (i = 0; i < npu; ++i) {
+        pzgather( a, i == me ? a2 : b, i, nn2, npu );
+        pzisend( b, nn2, i, p, me, npu );
+      }
+      MPI_Waitall( 2 * npu, p->req, MPI_STATUSES_IGNORE );
+    } else {
+      ztrans( a, b, npu, nn2 );
+      pztrans( b, a, nn, p, npu );
+    }
   }
 
   p->timings[2] = MPI_Wtime();
 
   nd = ((ny > nz ? ny : nz) + FFTE_NP) * FFTE_NBLK + FFTE_NP;
+  if (pencil && nx > ny && nx > nz) nd = (nx + FFTE_NP) * FFTE_NBLK + FFTE_NP;
 
 #ifdef _OPENMP
 #pragma omp parallel private(c,i)
@@ -361,7 +815,11 @@ HPCC_pzfft1d(s64Int_t n, fftw_complex *a, fftw_complex *b, fftw_complex *w, int
     c = p->c + i*p->c_size;
 #endif
 
-  pzfft1d0( a, a, a, a, b, b, b, c, c, c + nd, wx, wy, wz, w, w + ny*(nz/npu), nx, ny, nz, p, npu, lnx, lny, lnz );
+  if (pencil)
+    pzfft1d0p( a, b, c, c + nd, wx, wy, wz, w, w + ny*(nz/p->py), nx, ny, nz, p, lnx, lny, lnz );
+  else
+    pzfft1d0( a2, pipe ? p->buf : a, a, b, b, c, c, c + nd, wx, wy, wz, w, w + ny*(nz/npu), nx, ny, nz, p, me,
+              npu, pipe, lnx, lny, lnz );
 
 #ifdef _OPENMP
    }
@@ -369,8 +827,16 @@ HPCC_pzfft1d(s64Int_t n, fftw_complex *a, fftw_complex *b, fftw_complex *w, int
 
   p->timings[5] = MPI_Wtime();
 
-  if (-1 == iopt || 1 == iopt || 2 == iopt) {
-    pztrans( b, a, nn, p, npu );
+  if (pencil)
+    pzpencilout( b, a, nx, ny, nz, p );
+  else if (-1 == iopt || 1 == iopt || 2 == iopt) {
+    if (pipe & PIPE_LAST) {
+      for (i = 0; i < nn2; ++i) {
+        c_assgn( a[(s64Int_t)me * nn2 + i], b[(s64Int_t)me * nn2 + i] );
+      }
+      MPI_Waitall( 2 * npu, p->req, MPI_STATUSES_IGNORE );
+    } else
+      pztrans( b, a, nn, p, npu );
     ztrans( a, b, nn2, npu );
   }
 
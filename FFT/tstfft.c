@@ -7,13 +7,14 @@
 #include "hpccfft.h"
 
 static int
-TestFFT1(HPCC_Params *params, int doIO, FILE *outFile, double *UGflops, int *Un, int *Ufailure) {
+TestFFT1(HPCC_Params *params, int doIO, FILE *outFile, double *UGflops, int *Un, int *Uthreads,
+  int *Ufailure) {
   fftw_complex *in, *out;
   fftw_plan p;
   hpcc_fftw_plan ip;
   double Gflops = -1.0;
   double maxErr, tmp1, tmp2, tmp3, t0, t1, t2, t3;
-  int i, n, flags, failure = 1;
+  int i, n, flags, kernels, threads = 1, failure = 1;
   double deps = HPL_dlamch( HPL_MACH_EPS );
 
 #ifdef HPCC_FFT_235
@@ -52,18 +53,32 @@ TestFFT1(HPCC_Params *params, int doIO, FILE *outFile, double *UGflops, int *Un,
   HPCC_bcnrand( 2*(s64Int)n, 0, in );
   t0 += MPI_Wtime();
 
+  kernels = HPCC_fft235_kernels( params->FFTKernels );
+  params->FFTKernelsUsed = kernels;
+
 #ifdef HPCC_FFTW_ESTIMATE
   flags = FFTW_ESTIMATE;
 #else
   flags = FFTW_MEASURE;
 #endif
 
+  flags |= HPCC_fftw_wisdom( params->FFTWisdom, doIO );
+
   t1 = -MPI_Wtime();
   p = fftw_create_plan( n, FFTW_FORWARD, flags );
   t1 += MPI_Wtime();
 
   if (! p) goto comp_end;
 
+  HPCC_fftw_export_wisdom();
+
+  /* the built-in transform runs on the threads for which its plan was made */
+#ifdef USING_FFTW
+  threads = 1;
+#else
+  threads = p->threads;
+#endif
+
   t2 = -MPI_Wtime();
   fftw_one( p, in, out );
   t2 += MPI_Wtime();
@@ -93,6 +108,8 @@ TestFFT1(HPCC_Params *params, int doIO, FILE *outFile, double *UGflops, int *Un,
 
   if (doIO) {
     fprintf( outFile, "Vector size: %d\n", n );
+    fprintf( outFile, "Kernels: %s\n", HPCC_FFTKernelVariants[kernels - 1].name );
+    fprintf( outFile, "Threads: %d\n", threads );
     fprintf( outFile, "Generation time: %9.3f\n", t0 );
     fprintf( outFile, "Tuning: %9.3f\n", t1 );
     fprintf( outFile, "Computing: %9.3f\n", t2 );
@@ -109,14 +126,15 @@ TestFFT1(HPCC_Params *params, int doIO, FILE *outFile, double *UGflops, int *Un,
 
   *UGflops = Gflops;
   *Un = n;
+  *Uthreads = threads;
   *Ufailure = failure;
 
   return 0;
 }
 
 int
-HPCC_TestFFT(HPCC_Params *params, int doIO, double *UGflops, int *Un, int *Ufailure) {
-  int rv, n, failure = 1;
+HPCC_TestFFT(HPCC_Params *params, int doIO, double *UGflops, int *Un, int *Uthreads, int *Ufailure) {
+  int rv, n, threads, failure = 1;
   double Gflops;
   FILE *outFile;
 
@@ -131,7 +149,8 @@ HPCC_TestFFT(HPCC_Params *params, int doIO, double *UGflops, int *Un, int *Ufail
 
   n = 0;
   Gflops = -1.0;
-  rv = TestFFT1( params, doIO, outFile, &Gflops, &n, &failure );
+  threads = 1;
+  rv = TestFFT1( params, doIO, outFile, &Gflops, &n, &threads, &failure );
 
   if (doIO) {
     fflush( outFile );
@@ -140,6 +159,7 @@ HPCC_TestFFT(HPCC_Params *params, int doIO, double *UGflops, int *Un, int *Ufail
 
   if (UGflops) *UGflops = Gflops;
   if (Un) *Un = n;
+  if (Uthreads) *Uthreads = threads;
   if (Ufailure) *Ufailure = failure;
 
   return rv;
@@ -1,6 +1,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "hpccfft.h"
 
@@ -8,81 +9,289 @@
 #include <omp.h>
 #endif
 
-hpcc_fftw_plan
-HPCC_fftw_create_plan(int n, fftw_direction dir, int flags) {
-  hpcc_fftw_plan p;
-  fftw_complex *a = NULL, *b = NULL;
-  size_t w1_size, w2_size, ww1_size, ww2_size, ww3_size, ww4_size;
+/*
+  Plans are cached: a destroyed plan keeps its twiddle factors (only its
+  scratch vectors are freed) and is returned again for the same size,
+  direction and number of threads until HPCC_fftw_forget_plans(). The twiddle
+  factors depend only on the size, so a new plan copies them from a cached
+  plan of the same size. Failing that, they are read from the wisdom file of
+  the built-in plans if HPCC_fftw_wisdom() enabled it, and only then computed.
+ */
+static hpcc_fftw_plan PlanCache = NULL;
 
-  p = (hpcc_fftw_plan)fftw_malloc( sizeof *p );
-  if (! p) return p;
+static char *WisdomFile = NULL;
+static int WisdomSave = 0;
 
-  w1_size = Mmax( FFTE_NDA2/2 + FFTE_NP, (int)(1.100 * sqrt( n )) );
-  w2_size = Mmax( FFTE_NDA2/2 + FFTE_NP, (int)(0.375 * sqrt( n )) );
-  ww1_size = Mmax( FFTE_NDA2 + FFTE_NDA4*FFTE_NP + FFTE_NP, (int)(1.0 * sqrt( n )) );
-  ww2_size = Mmax( FFTE_NDA2 + FFTE_NDA4*FFTE_NP + FFTE_NP, (int)(3.9 * sqrt( n )) );
-  ww3_size = Mmax( FFTE_NDA2 + FFTE_NDA4*FFTE_NP + FFTE_NP, (int)(5.4773 * sqrt( n )) );
-  ww4_size = Mmax( FFTE_NDA2 + (1 << 13), (int)(1.0/256.0 * n) );
+#define PLAN_TABLES 6
 
-  p->w1 = (fftw_complex *)fftw_malloc( w1_size * (sizeof *p->w1) );
-  p->w2 = (fftw_complex *)fftw_malloc( w2_size * (sizeof *p->w2) );
-  p->ww1 = (fftw_complex *)fftw_malloc( ww1_size * (sizeof *p->ww1) );
-  p->ww2 = (fftw_complex *)fftw_malloc( ww2_size * (sizeof *p->ww1) );
-  p->ww3 = (fftw_complex *)fftw_malloc( ww3_size * (sizeof *p->ww1) );
-  p->ww4 = (fftw_complex *)fftw_malloc( ww4_size * (sizeof *p->ww1) );
+/* magic number of the records of the wisdom file: "HPCCFFTE" */
+#define WISDOM_MAGIC 0x4850434346465445LL
 
-  p->c_size = Mmax( (FFTE_NDA2+FFTE_NP) * FFTE_NBLK + FFTE_NP, (int)(16.75 * sqrt( n )) );
-  p->d_size = Mmax( FFTE_NDA2+FFTE_NP, (int)(1.0 * sqrt( n )) );
+static void
+PlanTables(hpcc_fftw_plan p, fftw_complex ***table, size_t *size) {
+  int n = p->n;
+
+  table[0] = &p->w1;
+  table[1] = &p->w2;
+  table[2] = &p->ww1;
+  table[3] = &p->ww2;
+  table[4] = &p->ww3;
+  table[5] = &p->ww4;
+
+  size[0] = Mmax( FFTE_NDA2/2 + FFTE_NP, (int)(1.100 * sqrt( n )) );
+  size[1] = Mmax( FFTE_NDA2/2 + FFTE_NP, (int)(0.375 * sqrt( n )) );
+  size[2] = Mmax( FFTE_NDA2 + FFTE_NDA4*FFTE_NP + FFTE_NP, (int)(1.0 * sqrt( n )) );
+  size[3] = Mmax( FFTE_NDA2 + FFTE_NDA4*FFTE_NP + FFTE_NP, (int)(3.9 * sqrt( n )) );
+  size[4] = Mmax( FFTE_NDA2 + FFTE_NDA4*FFTE_NP + FFTE_NP, (int)(5.4773 * sqrt( n )) );
+  size[5] = Mmax( FFTE_NDA2 + (1 << 13), (int)(1.0/256.0 * n) );
+}
+
+/* Allocates the scratch vectors `c' and `d': every thread gets its own part of them */
+static int
+PlanScratch(hpcc_fftw_plan p) {
+  p->c = (fftw_complex *)fftw_malloc( p->c_size * (sizeof *p->c) * p->threads );
+  p->d = (fftw_complex *)fftw_malloc( p->d_size * (sizeof *p->d) * p->threads );
+
+  if (! p->c || ! p->d) {
+    if (p->d) fftw_free( p->d );
+    if (p->c) fftw_free( p->c );
+    p->c = p->d = NULL;
+    return 1;
+  }
+
+  return 0;
+}
+
+static void
+FreePlan(hpcc_fftw_plan p) {
+  fftw_complex **table[PLAN_TABLES];
+  size_t size[PLAN_TABLES];
+  int i;
+
+  PlanTables( p, table, size );
+  for (i = 0; i < PLAN_TABLES; i++)
+    if (*table[i]) fftw_free( *table[i] );
+  if (p->d) fftw_free( p->d );
+  if (p->c) fftw_free( p->c );
+  fftw_free( p );
+}
+
+/*
+  The wisdom file of the built-in plans is a sequence of records in the byte
+  order of the machine, each made of PLAN_TABLES+3 64-bit integers (the magic
+  number, the size of fftw_complex, the size of the transform and the lengths
+  of the tables) followed by the tables. Records are only ever appended, so a
+  record that is being written by another process is seen as incomplete.
+ */
+static int
+ReadWisdom(hpcc_fftw_plan p) {
+  FILE *f;
+  fftw_complex **table[PLAN_TABLES];
+  size_t size[PLAN_TABLES];
+  s64Int_t head[PLAN_TABLES + 3], skip;
+  int i, found = 0;
+
+  if (! WisdomFile) return 0;
+  f = fopen( WisdomFile, "rb" );
+  if (! f) return 0;
+
+  PlanTables( p, table, size );
+
+  while (! found && fread( head, sizeof *head, PLAN_TABLES + 3, f ) == PLAN_TABLES + 3) {
+    if (WISDOM_MAGIC != head[0] || (s64Int_t)sizeof(fftw_complex) != head[1]) break;
+
+    for (found = head[2] == p->n, skip = 0, i = 0; i < PLAN_TABLES; i++) {
+      found = found && (s64Int_t)size[i] == head[i + 3];
+      skip += head[i + 3];
+    }
+
+    if (! found) {
+      if (fseek( f, (long)(skip * sizeof(fftw_complex)), SEEK_CUR )) break;
+      continue;
+    }
+
+    for (i = 0; i < PLAN_TABLES; i++)
+      if (fread( *table[i], sizeof(fftw_complex), size[i], f ) != size[i]) found = 0;
+  }
+
+  fclose( f );
+
+  return found;
+}
+
+static void
+WriteWisdom(hpcc_fftw_plan p) {
+  FILE *f;
+  fftw_complex **table[PLAN_TABLES];
+  size_t size[PLAN_TABLES];
+  s64Int_t head[PLAN_TABLES + 3];
+  int i;
+
+  if (! WisdomSave) return;
+  f = fopen( WisdomFile, "ab" );
+  if (! f) return;
+
+  PlanTables( p, table, size );
+
+  head[0] = WISDOM_MAGIC;
+  head[1] = sizeof(fftw_complex);
+  head[2] = p->n;
+  for (i = 0; i < PLAN_TABLES; i++)
+    head[i + 3] = size[i];
+
+  fwrite( head, sizeof *head, PLAN_TABLES + 3, f );
+  for (i = 0; i < PLAN_TABLES; i++)
+    fwrite( *table[i], sizeof(fftw_complex), size[i], f );
+
+  fclose( f );
+}
+
+hpcc_fftw_plan
+HPCC_fftw_create_plan(int n, fftw_direction dir, int flags) {
+  hpcc_fftw_plan p, q;
+  fftw_complex *a = NULL, *b = NULL, **table[PLAN_TABLES], **qtable[PLAN_TABLES];
+  size_t size[PLAN_TABLES];
+  int i, threads, failed;
+
+  threads = 1;
 #ifdef _OPENMP
 #pragma omp parallel
   {
 #pragma omp single
-    {
-      int i;
-      i = omp_get_num_threads();
-      p->c = (fftw_complex *)fftw_malloc( p->c_size * (sizeof *p->c) * i );
-      p->d = (fftw_complex *)fftw_malloc( p->d_size * (sizeof *p->d) * i );
-    }
+    threads = omp_get_num_threads();
   }
-#else
-  p->c = (fftw_complex *)fftw_malloc( p->c_size * (sizeof *p->c) );
-  p->d = (fftw_complex *)fftw_malloc( p->d_size * (sizeof *p->d) );
 #endif
 
-  if (! p->w1 || ! p->w2 || ! p->ww1 || ! p->ww2 || ! p->ww3 || ! p->ww4 || ! p->c || ! p->d) {
-    if (p->d) fftw_free( p->d );
-    if (p->c) fftw_free( p->c );
-    if (p->ww4) fftw_free( p->ww4 );
-    if (p->ww3) fftw_free( p->ww3 );
-    if (p->ww2) fftw_free( p->ww2 );
-    if (p->ww1) fftw_free( p->ww1 );
-    if (p->w2) fftw_free( p->w2 );
-    if (p->w1) fftw_free( p->w1 );
-    fftw_free( p );
-    return NULL;
-  }
+  for (p = PlanCache; p; p = p->next)
+    if (p->n == n && p->dir == dir && p->threads == threads) {
+      if (0 == p->refs && PlanScratch( p )) return NULL;
+      p->refs++;
+      p->flags = flags;
+      return p;
+    }
 
-  HPCC_zfft1d( n, a, b, 0, p );
+  p = (hpcc_fftw_plan)fftw_malloc( sizeof *p );
+  if (! p) return p;
 
   p->n = n;
   p->dir = dir;
   p->flags = flags;
+  p->threads = threads;
+  p->refs = 1;
+
+  PlanTables( p, table, size );
+  for (failed = 0, i = 0; i < PLAN_TABLES; i++) {
+    *table[i] = (fftw_complex *)fftw_malloc( size[i] * sizeof(fftw_complex) );
+    if (! *table[i]) failed = 1;
+  }
+
+  /* every thread gets its own part of `c' and `d'; the sizes are rounded up to FFTE_NP elements
+     so that the parts of different threads do not share cache lines */
+  p->c_size = Mmax( (FFTE_NDA2+FFTE_NP) * FFTE_NBLK + FFTE_NP, (int)(16.75 * sqrt( n )) );
+  p->d_size = Mmax( FFTE_NDA2+FFTE_NP, (int)(1.0 * sqrt( n )) );
+  p->c_size = (p->c_size + FFTE_NP - 1) / FFTE_NP * FFTE_NP;
+  p->d_size = (p->d_size + FFTE_NP - 1) / FFTE_NP * FFTE_NP;
+  p->c = p->d = NULL;
+
+  if (failed || PlanScratch( p )) {
+    FreePlan( p );
+    return NULL;
+  }
+
+  for (q = PlanCache; q && q->n != n; q = q->next)
+    ; /* EMPTY */
+
+  if (q) {
+    PlanTables( q, qtable, size );
+    for (i = 0; i < PLAN_TABLES; i++)
+      memcpy( *table[i], *qtable[i], size[i] * sizeof(fftw_complex) );
+  } else if (! ReadWisdom( p )) {
+    /* not all of the tables are used: clear them so that the wisdom file is reproducible */
+    if (WisdomSave)
+      for (i = 0; i < PLAN_TABLES; i++)
+        memset( *table[i], 0, size[i] * sizeof(fftw_complex) );
+
+    HPCC_zfft1d( n, a, b, 0, p );
+
+    WriteWisdom( p );
+  }
+
+  p->next = PlanCache;
+  PlanCache = p;
 
   return p;
 }
 
+/* Releases the scratch vectors of the plan; the plan itself stays in the cache */
 void
 HPCC_fftw_destroy_plan(hpcc_fftw_plan p) {
   if (! p) return;
+  if (--p->refs > 0) return;
   fftw_free( p->d );
   fftw_free( p->c );
-  fftw_free( p->ww4 );
-  fftw_free( p->ww3 );
-  fftw_free( p->ww2 );
-  fftw_free( p->ww1 );
-  fftw_free( p->w2 );
-  fftw_free( p->w1 );
-  fftw_free( p );
+  p->c = p->d = NULL;
+}
+
+/* Frees the cached plans that are not in use */
+void
+HPCC_fftw_forget_plans(void) {
+  hpcc_fftw_plan p, *link;
+
+  for (link = &PlanCache; (p = *link); ) {
+    if (p->refs) {
+      link = &p->next;
+      continue;
+    }
+    *link = p->next;
+    FreePlan( p );
+  }
+}
+
+/* If `use' is set, new built-in plans read their tables from HPCC_FFTE_WISDOM and the FFTW
+   wisdom is imported from HPCC_FFTW_WISDOM; if `save' is set as well, the tables of new plans
+   are appended to HPCC_FFTE_WISDOM and HPCC_fftw_export_wisdom() writes the FFTW wisdom. Only one
+   process should save. Returns the flags that make the FFTW planner use the wisdom. */
+int
+HPCC_fftw_wisdom(int use, int save) {
+#ifdef USING_FFTW
+  FILE *f;
+#endif
+
+  WisdomFile = use ? HPCC_FFTE_WISDOM : NULL;
+  WisdomSave = use && save;
+
+#ifdef USING_FFTW
+  if (! use) return 0;
+
+  f = fopen( HPCC_FFTW_WISDOM, "r" );
+  if (f) {
+    fftw_import_wisdom_from_file( f );
+    fclose( f );
+  }
+
+  return FFTW_USE_WISDOM;
+#else
+  return 0;
+#endif
+}
+
+/* Writes the FFTW wisdom: the file is replaced at once so other processes never read a partial
+   file */
+void
+HPCC_fftw_export_wisdom(void) {
+#ifdef USING_FFTW
+  FILE *f;
+
+  if (! WisdomSave) return;
+
+  f = fopen( HPCC_FFTW_WISDOM ".tmp", "w" );
+  if (! f) return;
+
+  fftw_export_wisdom_to_file( f );
+
+  if (fclose( f ) || rename( HPCC_FFTW_WISDOM ".tmp", HPCC_FFTW_WISDOM ))
+    remove( HPCC_FFTW_WISDOM ".tmp" );
+#endif
 }
 
 /* Without additional storage of size p->n there is no way to preserve FFTW 2
@@ -100,6 +309,9 @@ HPCC_fftw_one(hpcc_fftw_plan p, fftw_complex *in, fftw_complex *out) {
 
   n = p->n;
   /* Copy the transform to `out' vector. */
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(p->threads)
+#endif
   for (i = 0; i < n; ++i) {
     c_assgn( out[i], in[i] );
   }
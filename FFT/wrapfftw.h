@@ -19,15 +19,24 @@ typedef enum {
 
 struct hpcc_fftw_plan_struct {
   fftw_complex *w1, *w2, *ww1, *ww2, *ww3, *ww4, *c, *d;
-  int n, c_size, d_size;
+  int n, c_size, d_size, threads;
   int flags;
   fftw_direction dir;
+  int refs; /* number of users of the cached plan */
+  struct hpcc_fftw_plan_struct *next;
 };
 typedef struct hpcc_fftw_plan_struct *hpcc_fftw_plan;
 
 extern hpcc_fftw_plan HPCC_fftw_create_plan(int n, fftw_direction dir, int flags);
 extern void HPCC_fftw_destroy_plan(hpcc_fftw_plan plan);
 extern void HPCC_fftw_one(hpcc_fftw_plan plan, fftw_complex *in, fftw_complex *out);
+extern void HPCC_fftw_forget_plans(void);
+extern int HPCC_fftw_wisdom(int use, int save);
+extern void HPCC_fftw_export_wisdom(void);
+
+/* wisdom files in the working directory */
+#define HPCC_FFTE_WISDOM "hpccffte.wisdom"
+#define HPCC_FFTW_WISDOM "hpccfftw.wisdom"
 
 #ifndef USING_FFTW
 
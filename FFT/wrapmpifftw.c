@@ -10,13 +10,18 @@
 #define    Mmax3( a_, b_, c_ )      ( (a_) > (b_) ?  ((a_) > (c_) ? (a_) : (c_)) : ((b_) > (c_) ? (b_) : (c_)) )
 
 static int
-GetNXYZ(s64Int_t n, int npu) {
-  int ip[3], lnx[3], lny[3], lnz[3], lnpu[3];
+GetNXYZ(s64Int_t n, int py, int pz) {
+  int ip[3], lnx[3], lny[3], lnz[3], lnpu[3], lpz[3];
   int i, nx, ny, nz, nxyz;
 
-  HPCC_factor235( npu, lnpu );
+  HPCC_factor235( py, lnpu );
+  HPCC_factor235( pz, lpz );
   HPCC_factor235_8( n, ip );
 
+  for (i = 0; i < 3; ++i) {
+    EMAX( lnpu[i], lpz[i], lnpu[i] );
+  }
+
   for (i = 0; i < 3; ++i) {
     EMAX( lnz[i], lnpu[i], (ip[i]+1)/3 );
     EMAX( lnx[i], lnpu[i], (ip[i]-lnz[i]+1)/2 );
@@ -32,12 +37,31 @@ GetNXYZ(s64Int_t n, int npu) {
   return nxyz;
 }
 
+/* The most square py by pz grid of `size' processes with py <= pz, as in HPCC_ProcessGrid(); returns
+   lcm(py, pz), of which nx, ny and nz have to be multiples, or 0 if there is no grid (py is 1) */
+int
+HPCC_fftw_mpi_pencils(int size, int *py, int *pz) {
+  int y, l;
+
+  for (y = (int)sqrt( size ); y > 1 && size % y; --y)
+    ; /* EMPTY */
+
+  if (py) *py = y;
+  if (pz) *pz = size / y;
+  if (1 == y) return 0;
+
+  for (l = size / y; l % y; l += size / y)
+    ; /* EMPTY */
+
+  return l;
+}
+
 hpcc_fftw_mpi_plan
 HPCC_fftw_mpi_create_plan(MPI_Comm comm, s64Int_t n, fftw_direction dir, int flags) {
   hpcc_fftw_mpi_plan p;
   fftw_complex *a = NULL, *b = NULL;
   int nxyz;
-  int rank, size;
+  int rank, size, failed, anyFailed, l;
 
   MPI_Comm_size( comm, &size );
   MPI_Comm_rank( comm, &rank );
@@ -45,12 +69,25 @@ HPCC_fftw_mpi_create_plan(MPI_Comm comm, s64Int_t n, fftw_direction dir, int fla
   p = (hpcc_fftw_mpi_plan)fftw_malloc( sizeof *p );
   if (! p) return p;
 
-  nxyz = GetNXYZ( n, size );
+  /* the pencil decomposition needs more than one row and column of processes and a multiple of
+     lcm(py, pz) cubed; it replaces the pipelined transposes */
+  l = HPCC_fftw_mpi_pencils( size, &p->py, &p->pz );
+  if (! (flags & HPCC_FFTW_PENCIL) || ! l || n % ((s64Int_t)l * l * l)) {
+    flags &= ~HPCC_FFTW_PENCIL;
+    p->py = 1;
+    p->pz = size;
+  } else
+    flags &= ~HPCC_FFTW_PIPELINE;
+
+  nxyz = GetNXYZ( n, p->py, p->pz );
 
   p->wx = (fftw_complex *)HPCC_fftw_malloc( (nxyz/2 + FFTE_NP) * (sizeof *p->wx) );
   p->wy = (fftw_complex *)HPCC_fftw_malloc( (nxyz/2 + FFTE_NP) * (sizeof *p->wy) );
   p->wz = (fftw_complex *)HPCC_fftw_malloc( (nxyz/2 + FFTE_NP) * (sizeof *p->wz) );
-  p->work = (fftw_complex *)HPCC_fftw_malloc( n / size * 3 / 2 * (sizeof *p->work) );
+  /* the twiddle factors: ny*nz/npu and n/size of them or, with pencils, ny*nz/py (no more than n/size
+     as pz divides nx) and n/size */
+  p->work = (fftw_complex *)HPCC_fftw_malloc( n / size * (flags & HPCC_FFTW_PENCIL ? 4 : 3) / 2 *
+                                              (sizeof *p->work) );
 
   p->c_size = (nxyz+FFTE_NP) * (FFTE_NBLK + 1) + FFTE_NP;
 #ifdef _OPENMP
@@ -77,6 +114,24 @@ HPCC_fftw_mpi_create_plan(MPI_Comm comm, s64Int_t n, fftw_direction dir, int fla
     return NULL;
   }
 
+  /* the pipelined transposes need another local vector; without it (on any process) the plan
+     falls back to MPI_Alltoall */
+  p->buf = NULL;
+  p->req = NULL;
+  if ((flags & HPCC_FFTW_PIPELINE) && size > 1) {
+    p->buf = (fftw_complex *)HPCC_fftw_malloc( n / size * (sizeof *p->buf) );
+    p->req = (MPI_Request *)malloc( 2 * size * (sizeof *p->req) );
+    failed = ! p->buf || ! p->req;
+    MPI_Allreduce( &failed, &anyFailed, 1, MPI_INT, MPI_MAX, comm );
+    if (anyFailed) {
+      if (p->req) free( p->req );
+      if (p->buf) HPCC_fftw_free( p->buf );
+      p->buf = NULL;
+      p->req = NULL;
+    }
+  }
+  if (! p->buf) flags &= ~HPCC_FFTW_PIPELINE;
+
   p->n = n;
   p->comm = comm;
   p->dir = dir;
@@ -85,6 +140,12 @@ HPCC_fftw_mpi_create_plan(MPI_Comm comm, s64Int_t n, fftw_direction dir, int fla
   MPI_Type_contiguous( 2, MPI_DOUBLE, &p->cmplx );
   MPI_Type_commit( &p->cmplx );
 
+  p->commy = p->commz = MPI_COMM_NULL;
+  if (flags & HPCC_FFTW_PENCIL) {
+    MPI_Comm_split( comm, rank % p->pz, rank / p->pz, &p->commy );
+    MPI_Comm_split( comm, rank / p->pz, rank % p->pz, &p->commz );
+  }
+
   if (FFTW_FORWARD == p->dir)
     p->timings = HPCC_fft_timings_forward;
   else
@@ -99,8 +160,14 @@ void
 HPCC_fftw_mpi_destroy_plan(hpcc_fftw_mpi_plan p) {
   if (!p) return;
 
+  if (p->flags & HPCC_FFTW_PENCIL) {
+    MPI_Comm_free( &p->commz );
+    MPI_Comm_free( &p->commy );
+  }
   MPI_Type_free( &p->cmplx );
 
+  if (p->req) free( p->req );
+  if (p->buf) HPCC_fftw_free( p->buf );
   HPCC_fftw_free( p->work );
   HPCC_fftw_free( p->c );
   HPCC_fftw_free( p->wz );
@@ -9,12 +9,18 @@ typedef struct hpcc_fftw_mpi_plan_struct *fftw_mpi_plan;
 #define fftw_mpi_local_sizes HPCC_fftw_mpi_local_sizes
 #endif
 
+/* plan flags of HPCC_pzfft1d(), never passed to FFTW: overlap the transposes with the transforms;
+   use a two-dimensional (pencil) decomposition over a py by pz process grid */
+#define HPCC_FFTW_PIPELINE (1 << 20)
+#define HPCC_FFTW_PENCIL   (1 << 21)
+
 struct hpcc_fftw_mpi_plan_struct {
-  MPI_Comm comm;
+  MPI_Comm comm, commy, commz;
   MPI_Datatype cmplx;
-  fftw_complex *wx, *wy, *wz, *c, *work;
+  MPI_Request *req;
+  fftw_complex *wx, *wy, *wz, *c, *work, *buf;
   s64Int_t n;
-  int flags, c_size;
+  int flags, c_size, py, pz;
   fftw_direction dir;
   double *timings;
 };
@@ -29,6 +35,8 @@ extern void HPCC_fftw_mpi_local_sizes(hpcc_fftw_mpi_plan p, s64Int_t *local_n,
               s64Int_t *local_start, s64Int_t *local_n_after_transform,
               s64Int_t *local_start_after_transform, s64Int_t *total_local_size);
 
+extern int HPCC_fftw_mpi_pencils(int size, int *py, int *pz);
+
 extern int
 HPCC_pzfft1d(s64Int_t n, fftw_complex *a, fftw_complex *b, fftw_complex *w, int me, int npu, int iopt,
   hpcc_fftw_mpi_plan p);
@@ -176,6 +176,36 @@ zfft1d0(fftw_complex *a1, fftw_complex *a2, fftw_complex *b, fftw_complex *c, ff
   return 0;
 }
 
+/* The inverse transform is the conjugate of the forward transform of the conjugate scaled by 1/n.
+   Within a parallel region the loops are shared by the threads of the region. */
+static void
+conjg(fftw_complex *a, int n) {
+  int i;
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
+  for (i = 0; i < n; ++i) {
+    c_im( a[i] ) = -c_im( a[i] );
+  }
+}
+
+static void
+conjgscale(fftw_complex *a, int n) {
+  int i;
+  double dn;
+
+  dn = 1.0 / (double)n;
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
+  for (i = 0; i < n; ++i) {
+    c_re( a[i] ) *= dn;
+    c_im( a[i] ) *= -dn;
+  }
+}
+
 static int
 settbls(fftw_complex *w1, fftw_complex *w2, fftw_complex *w3, fftw_complex *w4,
   int n1, int n2, int m1, int m2) {
@@ -233,8 +263,7 @@ settbls(fftw_complex *w1, fftw_complex *w2, fftw_complex *w3, fftw_complex *w4,
 int
 HPCC_zfft1d(int n, fftw_complex *a, fftw_complex *b, int iopt, hpcc_fftw_plan p) {
   int i;
-  int m1, m2, n1, n2, nd;
-  double dn;
+  int m1, m2, n1, n2;
   int ip[3], ip1[3], ip2[3];
   fftw_complex *w1, *w2, *ww1, *ww2, *ww3, *ww4, *c, *d;
 
@@ -249,18 +278,15 @@ HPCC_zfft1d(int n, fftw_complex *a, fftw_complex *b, int iopt, hpcc_fftw_plan p)
 
   HPCC_factor235( n, ip );
 
-  if (1 == iopt)
-    for (i = 0; i < n; ++i) {
-      c_im( a[i] ) = -c_im( a[i] );
-    }
-
   if (n <= FFTE_L2SIZE / 16 / 3 && n <= FFTE_NDA2) {
     if (0 == iopt) {
       HPCC_settbl( w1, n );
       return 0;
     }
 
+    if (1 == iopt) conjg( a, n );
     HPCC_fft235( a, b, w1, n, ip );
+    if (1 == iopt) conjgscale( a, n );
   } else {
     for (i = 0; i < 3; ++i) {
       ip1[i] = (ip[i] + 1) / 2;
@@ -291,31 +317,28 @@ HPCC_zfft1d(int n, fftw_complex *a, fftw_complex *b, int iopt, hpcc_fftw_plan p)
       return 0;
     }
 
-    nd = (n2 + FFTE_NP) * FFTE_NBLK + FFTE_NP;
-
+    /* a single parallel region for the whole transform: the threads share the twiddle factors,
+       which are only read, and each one uses its own part of the blocking buffers `c' and `d' of
+       the plan, which has room for p->threads threads */
 #ifdef _OPENMP
-#pragma omp parallel private(c,i)
+#pragma omp parallel private(c,d,i) num_threads(p->threads)
    {
     i = omp_get_thread_num();
     c = p->c + i*p->c_size;
     d = p->d + i*p->d_size;
 #endif
 
+    if (1 == iopt) conjg( a, n );
+
     zfft1d0( a, a, b, c, d, w1, w2, ww1, ww2, ww3, ww4, n1, n2, m1, m2, ip1, ip2 );
 
+    if (1 == iopt) conjgscale( a, n );
+
 #ifdef _OPENMP
    }
 #endif
 
   }
 
-  if (1 == iopt) {
-    dn = 1.0 / (double)n;
-    for (i = 0; i < n; ++i) {
-      c_re( a[i] ) *= dn;
-      c_im( a[i] ) *= -dn;
-    }
-  }
-
   return 0;
 }	/* HPCC_zfft1d */
@@ -120,7 +120,6 @@
 /* Allocate main table (in global memory) */
 u64Int *HPCC_Table;
 
-u64Int LocalSendBuffer[LOCAL_BUFFER_SIZE];
 u64Int LocalRecvBuffer[MAX_RECV*LOCAL_BUFFER_SIZE];
 
 #ifndef LONG_IS_64BITS
@@ -129,16 +128,6 @@ Sum64(void *invec, void *inoutvec, int *len, MPI_Datatype *datatype) {
   int i, n = *len; s64Int *invec64 = (s64Int *)invec, *inoutvec64 = (s64Int *)inoutvec;
   for (i = n; i; i--, invec64++, inoutvec64++) *inoutvec64 += *invec64;
 }
-
-static void
-MinInt64(void *invec, void *inoutvec, int *len, MPI_Datatype *datatype) {
-  int i, n = *len; s64Int *invec64 = (s64Int *)invec, *inoutvec64 = (s64Int *)inoutvec, min_val;
-  if (datatype)
-    for (i = n; i; i--, invec64++, inoutvec64++) {
-      min_val = inoutvec64[0];
-      *inoutvec64 = *inoutvec64 > *invec64 ? *invec64 : *inoutvec64;
-    }
-}
 #endif
 
 #ifdef HPCC_RA_STDALG
@@ -148,9 +137,10 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   int proc_count;
 
   s64Int SendCnt;
-  u64Int Ran;
+  u64Int Ran, State;
   s64Int WhichPe;
   u64Int GlobalOffset, LocalOffset;
+  int shift = HPCC_RA_SHIFT( tparams.Generator, tparams.logTableSize );
   int NumberReceiving = tparams.NumProcs - 1;
 #ifdef USE_MULTIPLE_RECV
   int index, NumRecvs;
@@ -159,7 +149,6 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 #else
   MPI_Request inreq, outreq = MPI_REQUEST_NULL;
 #endif
-  u64Int inmsg;
   int bufferBase;
 
   MPI_Status status;
@@ -172,6 +161,7 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   int peUpdates;
   int recvUpdates;
   Bucket_Ptr Buckets;
+  u64Int *sendBuffer;
 
   pendingUpdates = 0;
   maxPendingUpdates = MAX_TOTAL_PENDING_UPDATES;
@@ -186,10 +176,12 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
    *       Ran = (Ran << 1) ^ (((s64Int) Ran < 0) ? POLY : 0);
    *       Table[Ran & (TABSIZE-1)] ^= Ran;
    *     }
+   *
+   * for the POLY generator (see generator.h for the others).
    */
 
   SendCnt = tparams.ProcNumUpdates; /* SendCnt = (4 * LocalTableSize); */
-  Ran = HPCC_starts (4 * tparams.GlobalStartMyProc);
+  State = HPCC_RandomAccessSeed( tparams.Generator, 4 * tparams.GlobalStartMyProc );
 
   i = 0;
 
@@ -221,11 +213,8 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 #else
           bufferBase = 0;
 #endif
-          for (j=0; j < recvUpdates; j ++) {
-            inmsg = LocalRecvBuffer[bufferBase+j];
-            LocalOffset = (inmsg & (tparams.TableSize - 1)) - tparams.GlobalStartMyProc;
-            HPCC_Table[LocalOffset] ^= inmsg;
-          }
+          HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                                  shift, tparams.TableSize - 1, tparams.GlobalStartMyProc );
 
         } else if (status.MPI_TAG == FINISHED_TAG) {
           /* we got a done message.  Thanks for playing... */
@@ -246,15 +235,15 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 
 
     if (pendingUpdates < maxPendingUpdates) {
-      Ran = (Ran << 1) ^ ((s64Int) Ran < ZERO64B ? POLY : ZERO64B);
-      GlobalOffset = Ran & (tparams.TableSize-1);
+      Ran = HPCC_RA_NEXT( tparams.Generator, State );
+      GlobalOffset = (Ran >> shift) & (tparams.TableSize-1);
       if ( GlobalOffset < tparams.Top)
         WhichPe = ( GlobalOffset / (tparams.MinLocalTableSize + 1) );
       else
         WhichPe = ( (GlobalOffset - tparams.Remainder) / tparams.MinLocalTableSize );
 
       if (WhichPe == tparams.MyProc) {
-        LocalOffset = (Ran & (tparams.TableSize - 1)) - tparams.GlobalStartMyProc;
+        LocalOffset = GlobalOffset - tparams.GlobalStartMyProc;
         HPCC_Table[LocalOffset] ^= Ran;
       }
       else {
@@ -268,8 +257,8 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
       MPI_Test(&outreq, &have_done, MPI_STATUS_IGNORE);
       if (have_done) {
         outreq = MPI_REQUEST_NULL;
-        pe = HPCC_GetUpdates(Buckets, LocalSendBuffer, localBufferSize, &peUpdates);
-        MPI_Isend(&LocalSendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
+        sendBuffer = HPCC_TakeUpdates(Buckets, &pe, &peUpdates);
+        MPI_Isend(sendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
                   MPI_COMM_WORLD, &outreq);
         pendingUpdates -= peUpdates;
       }
@@ -295,11 +284,8 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 #else
           bufferBase = 0;
 #endif
-          for (j=0; j < recvUpdates; j ++) {
-            inmsg = LocalRecvBuffer[bufferBase+j];
-            LocalOffset = (inmsg & (tparams.TableSize - 1)) - tparams.GlobalStartMyProc;
-            HPCC_Table[LocalOffset] ^= inmsg;
-          }
+          HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                                  shift, tparams.TableSize - 1, tparams.GlobalStartMyProc );
 
         } else if (status.MPI_TAG == FINISHED_TAG) {
           /* we got a done message.  Thanks for playing... */
@@ -322,8 +308,8 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
     MPI_Test(&outreq, &have_done, MPI_STATUS_IGNORE);
     if (have_done) {
       outreq = MPI_REQUEST_NULL;
-      pe = HPCC_GetUpdates(Buckets, LocalSendBuffer, localBufferSize, &peUpdates);
-      MPI_Isend(&LocalSendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
+      sendBuffer = HPCC_TakeUpdates(Buckets, &pe, &peUpdates);
+      MPI_Isend(sendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
                 MPI_COMM_WORLD, &outreq);
       pendingUpdates -= peUpdates;
     }
@@ -334,7 +320,7 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   for (proc_count = 0 ; proc_count < tparams.NumProcs ; ++proc_count) {
     if (proc_count == tparams.MyProc) { tparams.finish_req[tparams.MyProc] = MPI_REQUEST_NULL; continue; }
     /* send garbage - who cares, no one will look at it */
-    MPI_Isend(&Ran, 0, tparams.dtype64, proc_count, FINISHED_TAG,
+    MPI_Isend(&State, 0, tparams.dtype64, proc_count, FINISHED_TAG,
               MPI_COMM_WORLD, tparams.finish_req + proc_count);
   }
 
@@ -352,11 +338,8 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 #else
       bufferBase = 0;
 #endif
-      for (j=0; j < recvUpdates; j ++) {
-        inmsg = LocalRecvBuffer[bufferBase+j];
-        LocalOffset = (inmsg & (tparams.TableSize - 1)) - tparams.GlobalStartMyProc;
-        HPCC_Table[LocalOffset] ^= inmsg;
-      }
+      HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                              shift, tparams.TableSize - 1, tparams.GlobalStartMyProc );
 
     } else if (status.MPI_TAG == FINISHED_TAG) {
       /* we got a done message.  Thanks for playing... */
@@ -377,7 +360,6 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   MPI_Waitall( tparams.NumProcs, tparams.finish_req, tparams.finish_statuses);
 
   /* Be nice and clean up after ourselves */
-  HPCC_FreeBuckets(Buckets, tparams.NumProcs);
 #ifdef USE_MULTIPLE_RECV
   for (j = 0; j < NumRecvs; j++) {
     MPI_Cancel(&inreq[j]);
@@ -388,6 +370,7 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   MPI_Wait(&inreq, MPI_STATUS_IGNORE);
 #endif
   MPI_Wait(&outreq, MPI_STATUS_IGNORE);
+  HPCC_FreeBuckets(Buckets, tparams.NumProcs);
 
   /* end multiprocessor code */
 }
@@ -398,9 +381,10 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   int proc_count;
 
   s64Int SendCnt;
-  u64Int Ran;
+  u64Int Ran, State;
   s64Int WhichPe;
-  u64Int LocalOffset;
+  u64Int GlobalOffset, LocalOffset;
+  int shift = HPCC_RA_SHIFT( tparams.Generator, tparams.logTableSize );
   int logLocalTableSize = tparams.logTableSize - tparams.logNumProcs;
   int NumberReceiving = tparams.NumProcs - 1;
 #ifdef USE_MULTIPLE_RECV
@@ -410,7 +394,6 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 #else
   MPI_Request inreq, outreq = MPI_REQUEST_NULL;
 #endif
-  u64Int inmsg;
   int bufferBase;
 
   MPI_Status status;
@@ -423,6 +406,7 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   int peUpdates;
   int recvUpdates;
   Bucket_Ptr Buckets;
+  u64Int *sendBuffer;
 
   pendingUpdates = 0;
   maxPendingUpdates = MAX_TOTAL_PENDING_UPDATES;
@@ -437,10 +421,12 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
    *       Ran = (Ran << 1) ^ (((s64Int) Ran < 0) ? POLY : 0);
    *       Table[Ran & (TABSIZE-1)] ^= Ran;
    *     }
+   *
+   * for the POLY generator (see generator.h for the others).
    */
 
   SendCnt = tparams.ProcNumUpdates; /*  SendCnt = (4 * LocalTableSize); */
-  Ran = HPCC_starts (4 * tparams.GlobalStartMyProc);
+  State = HPCC_RandomAccessSeed( tparams.Generator, 4 * tparams.GlobalStartMyProc );
 
   i = 0;
 
@@ -472,10 +458,8 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 #else
           bufferBase = 0;
 #endif
-          for (j=0; j < recvUpdates; j ++) {
-            inmsg = LocalRecvBuffer[bufferBase+j];
-            HPCC_Table[inmsg & (tparams.LocalTableSize-1)] ^= inmsg;
-          }
+          HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                                  shift, tparams.LocalTableSize - 1, 0 );
 
         } else if (status.MPI_TAG == FINISHED_TAG) {
           /* we got a done message.  Thanks for playing... */
@@ -496,10 +480,11 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 
 
     if (pendingUpdates < maxPendingUpdates) {
-      Ran = (Ran << 1) ^ ((s64Int) Ran < ZERO64B ? POLY : ZERO64B);
-      WhichPe = (Ran >> logLocalTableSize) & (tparams.NumProcs - 1);
+      Ran = HPCC_RA_NEXT( tparams.Generator, State );
+      GlobalOffset = (Ran >> shift) & (tparams.TableSize-1);
+      WhichPe = GlobalOffset >> logLocalTableSize;
       if (WhichPe == tparams.MyProc) {
-        LocalOffset = (Ran & (tparams.TableSize - 1)) - tparams.GlobalStartMyProc;
+        LocalOffset = GlobalOffset - tparams.GlobalStartMyProc;
         HPCC_Table[LocalOffset] ^= Ran;
       }
       else {
@@ -513,8 +498,8 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
       MPI_Test(&outreq, &have_done, MPI_STATUS_IGNORE);
       if (have_done) {
         outreq = MPI_REQUEST_NULL;
-        pe = HPCC_GetUpdates(Buckets, LocalSendBuffer, localBufferSize, &peUpdates);
-        MPI_Isend(&LocalSendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
+        sendBuffer = HPCC_TakeUpdates(Buckets, &pe, &peUpdates);
+        MPI_Isend(sendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
                   MPI_COMM_WORLD, &outreq);
         pendingUpdates -= peUpdates;
       }
@@ -541,10 +526,8 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 #else
           bufferBase = 0;
 #endif
-          for (j=0; j < recvUpdates; j ++) {
-            inmsg = LocalRecvBuffer[bufferBase+j];
-            HPCC_Table[inmsg & (tparams.LocalTableSize-1)] ^= inmsg;
-          }
+          HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                                  shift, tparams.LocalTableSize - 1, 0 );
         } else if (status.MPI_TAG == FINISHED_TAG) {
           /* we got a done message.  Thanks for playing... */
           NumberReceiving--;
@@ -566,8 +549,8 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
     MPI_Test(&outreq, &have_done, MPI_STATUS_IGNORE);
     if (have_done) {
       outreq = MPI_REQUEST_NULL;
-      pe = HPCC_GetUpdates(Buckets, LocalSendBuffer, localBufferSize, &peUpdates);
-      MPI_Isend(&LocalSendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
+      sendBuffer = HPCC_TakeUpdates(Buckets, &pe, &peUpdates);
+      MPI_Isend(sendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
                 MPI_COMM_WORLD, &outreq);
       pendingUpdates -= peUpdates;
     }
@@ -578,7 +561,7 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   for (proc_count = 0 ; proc_count < tparams.NumProcs ; ++proc_count) {
     if (proc_count == tparams.MyProc) { tparams.finish_req[tparams.MyProc] = MPI_REQUEST_NULL; continue; }
     /* send garbage - who cares, no one will look at it */
-    MPI_Isend(&Ran, 0, tparams.dtype64, proc_count, FINISHED_TAG,
+    MPI_Isend(&State, 0, tparams.dtype64, proc_count, FINISHED_TAG,
               MPI_COMM_WORLD, tparams.finish_req + proc_count);
   }
 
@@ -596,10 +579,8 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 #else
       bufferBase = 0;
 #endif
-      for (j=0; j < recvUpdates; j ++) {
-        inmsg = LocalRecvBuffer[bufferBase+j];
-        HPCC_Table[inmsg & (tparams.LocalTableSize-1)] ^= inmsg;
-      }
+      HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                              shift, tparams.LocalTableSize - 1, 0 );
 
     } else if (status.MPI_TAG == FINISHED_TAG) {
       /* we got a done message.  Thanks for playing... */
@@ -620,7 +601,6 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   MPI_Waitall( tparams.NumProcs, tparams.finish_req, tparams.finish_statuses);
 
   /* Be nice and clean up after ourselves */
-  HPCC_FreeBuckets(Buckets, tparams.NumProcs);
 #ifdef USE_MULTIPLE_RECV
   for (j = 0; j < NumRecvs; j++) {
     MPI_Cancel(&inreq[j]);
@@ -631,14 +611,99 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   MPI_Wait(&inreq, MPI_STATUS_IGNORE);
 #endif
   MPI_Wait(&outreq, MPI_STATUS_IGNORE);
+  HPCC_FreeBuckets(Buckets, tparams.NumProcs);
 
   /* end multiprocessor code */
 }
 #endif
 
-int
-HPCC_MPIRandomAccess(HPCC_Params *params) {
-  s64Int i, NumErrors, GlbNumErrors;
+/* Verifies the table and returns the global number of errors (on process 0 only) */
+static s64Int
+MPIRandomAccessCheck(HPCC_Params *params, HPCC_RandomAccess_tabparams_t tparams, int PowerofTwo,
+  FILE *outFile) {
+  s64Int NumErrors, GlbNumErrors = 0;
+#ifndef LONG_IS_64BITS
+  MPI_Op sum64;
+#endif
+
+  HPCC_MPIRandomAccessVerify( params, tparams, PowerofTwo, outFile, &NumErrors );
+
+
+#ifdef LONG_IS_64BITS
+  MPI_Reduce( &NumErrors, &GlbNumErrors, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD );
+#else
+  /* MPI 1.1 standard (obsolete at this point) doesn't define MPI_SUM
+    to work on `long long':
+    http://www.mpi-forum.org/docs/mpi-11-html/node78.html and
+    therefore LAM 6.5.6 chooses not to implement it (even though there
+    is code for it in LAM and for other reductions work OK,
+    e.g. MPI_MAX). MPICH 1.2.5 doesn't complain about MPI_SUM but it
+    doesn't have MPI_UNSIGNED_LONG_LONG (but has MPI_LONG_LONG_INT):
+    http://www.mpi-forum.org/docs/mpi-20-html/node84.htm So I need to
+    create a trivial summation operation. */
+  MPI_Op_create( Sum64, 1, &sum64 );
+  MPI_Reduce( &NumErrors, &GlbNumErrors, 1, tparams.dtype64, sum64, 0, MPI_COMM_WORLD );
+  MPI_Op_free( &sum64 );
+#endif
+
+  return GlbNumErrors;
+}
+
+/* Runs and verifies `update' on the re-initialized table and reports it as `name' */
+static void
+MPIRandomAccessRerun(HPCC_Params *params, HPCC_RandomAccess_tabparams_t tparams, int PowerofTwo,
+  u64Int NumUpdates, FILE *outFile, int (*update)(HPCC_RandomAccess_tabparams_t), char *name,
+  double *GUPs, double *time, s64Int *errors) {
+  s64Int i, GlbNumErrors;
+  double RealTime;
+  int status;
+
+  for (i=0; i<tparams.LocalTableSize; i++)
+    HPCC_Table[i] = i + tparams.GlobalStartMyProc;
+
+  MPI_Barrier( MPI_COMM_WORLD );
+
+  RealTime = -RTSEC();
+
+  status = update( tparams );
+
+  MPI_Barrier( MPI_COMM_WORLD );
+
+  RealTime += RTSEC();
+
+  if (status) {
+    if (tparams.MyProc == 0)
+      fprintf( outFile, "%s updates are not supported by the MPI library.\n", name );
+    return;
+  }
+
+  GlbNumErrors = MPIRandomAccessCheck( params, tparams, PowerofTwo, outFile );
+
+  if (tparams.MyProc == 0) {
+    *time = RealTime;
+    *GUPs = 1e-9*NumUpdates / RealTime;
+    *errors = GlbNumErrors;
+    fprintf( outFile, "%s updates: Real time used = %.6f seconds\n", name, RealTime );
+    fprintf( outFile, "%.9f Billion(10^9) Updates    per second [GUP/s] (%s)\n", *GUPs, name );
+    fprintf( outFile, "Found " FSTR64 " errors in " FSTR64 " locations (%s).\n",
+             GlbNumErrors, tparams.TableSize, (GlbNumErrors <= 0.01*tparams.TableSize) ?
+             "passed" : "failed");
+    if (GlbNumErrors > 0.01*tparams.TableSize) params->Failure = 1;
+  }
+}
+
+/* Where the results of one of the MPIRandomAccess benchmarks are stored */
+typedef struct {
+  s64Int *N, *ExeUpdates, *Errors;
+  double *GUPs, *time, *CheckTime, *TimeBound, *PredictedTime, *ErrorsFraction;
+  int *Algorithm;
+  int Rerun; /* non-zero to repeat the run with the alternative algorithms */
+} MPIRandomAccessResults;
+
+/* Runs the benchmark with generator `gen' */
+static int
+MPIRandomAccessRun(HPCC_Params *params, int gen, MPIRandomAccessResults *res) {
+  s64Int i, GlbNumErrors;
 
   double CPUTime;  /* CPU  time to update table */
   double RealTime; /* Real time to update table */
@@ -652,12 +717,8 @@ HPCC_MPIRandomAccess(HPCC_Params *params) {
   u64Int NumUpdates;  /* actual number of updates to table - may be smaller than
                        * NumUpdates_Default due to execution time bounds */
 
-#ifdef RA_TIME_BOUND
-  s64Int localProcNumUpdates, GlbNumUpdates;  /* for reduction */
-#ifndef LONG_IS_64BITS
-  MPI_Op min_int64;
-#endif
-#endif
+  double predictedTime = -1; /* run time predicted from the sampled updates */
+  int sampleRounds = 0;
 
   FILE *outFile = NULL;
   double *GUPs;
@@ -667,11 +728,16 @@ HPCC_MPIRandomAccess(HPCC_Params *params) {
 #ifdef LONG_IS_64BITS
   tparams.dtype64 = MPI_LONG;
 #else
-  MPI_Op sum64;
   tparams.dtype64 = MPI_LONG_LONG_INT;
 #endif
 
-  GUPs = &params->MPIRandomAccess_GUPs;
+  GUPs = res->GUPs;
+
+#ifndef HPCC_RA_STDALG
+  /* the Sandia algorithms only implement the POLY and LCG generators */
+  if (HPCC_RA_PHILOX == gen) gen = HPCC_RA_POLY;
+#endif
+  tparams.Generator = gen;
 
   MPI_Comm_size( MPI_COMM_WORLD, &tparams.NumProcs );
   MPI_Comm_rank( MPI_COMM_WORLD, &tparams.MyProc );
@@ -731,7 +797,7 @@ HPCC_MPIRandomAccess(HPCC_Params *params) {
   sAbort = 0;
   tparams.finish_statuses = XMALLOC( MPI_Status, tparams.NumProcs );
   tparams.finish_req = XMALLOC( MPI_Request, tparams.NumProcs );
-  HPCC_Table = HPCC_XMALLOC( u64Int, tparams.LocalTableSize );
+  HPCC_Table = HPCC_RandomAccessTableAlloc( params, tparams.LocalTableSize );
 
   if (! tparams.finish_statuses || ! tparams.finish_req || ! HPCC_Table) sAbort = 1;
 
@@ -741,12 +807,12 @@ HPCC_MPIRandomAccess(HPCC_Params *params) {
     /* check all allocations in case there are new added and their order changes */
     if (tparams.finish_statuses) free( tparams.finish_statuses );
     if (tparams.finish_req) free( tparams.finish_req );
-    if (HPCC_Table) HPCC_free( HPCC_Table );
+    if (HPCC_Table) HPCC_RandomAccessTableFree( params, HPCC_Table, tparams.LocalTableSize );
 
     goto failed_table;
   }
 
-  params->MPIRandomAccess_N = (s64Int)tparams.TableSize;
+  *res->N = (s64Int)tparams.TableSize;
 
   /* Default number of global updates to table: 4x number of table entries */
   NumUpdates_Default = 4 * tparams.TableSize;
@@ -757,24 +823,13 @@ HPCC_MPIRandomAccess(HPCC_Params *params) {
 #ifdef HPCC_RA_STDALG
 #ifdef RA_TIME_BOUND
   /* estimate number of updates such that execution time does not exceed time bound */
-  /* time_bound should be a parameter */
-  /* max run time in seconds */
-  MPI_Allreduce( &params->HPLrdata.time, &timeBound, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD );
-  timeBound = Mmax( 0.25 * timeBound, (double)TIME_BOUND );
-  if (PowerofTwo) {
-    HPCC_Power2NodesTime( tparams, timeBound, (u64Int *)&localProcNumUpdates );
-  } else {
-    HPCC_AnyNodesTime( tparams, timeBound, (u64Int *)&localProcNumUpdates );
+  /* max run time in seconds: RA_TimeBound or a quarter of HPL's run time, whichever is longer */
+  if (params->RandomAccessTimeBound > 0.0) {
+    MPI_Allreduce( &params->HPLrdata.time, &timeBound, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD );
+    timeBound = Mmax( 0.25 * timeBound, params->RandomAccessTimeBound );
+    tparams.ProcNumUpdates = HPCC_RandomAccessTimeBound( params, tparams, PowerofTwo ?
+      HPCC_Power2NodesTime : HPCC_AnyNodesTime, timeBound, &predictedTime, &sampleRounds );
   }
-  /* be conservative: get the smallest number of updates among all procs */
-#ifdef LONG_IS_64BITS
-  MPI_Allreduce( &localProcNumUpdates, &GlbNumUpdates, 1, MPI_LONG, MPI_MIN, MPI_COMM_WORLD );
-#else
-  MPI_Op_create( MinInt64, 1, &min_int64 );
-  MPI_Allreduce( &localProcNumUpdates, &GlbNumUpdates, 1, tparams.dtype64, min_int64, MPI_COMM_WORLD );
-  MPI_Op_free( &min_int64 );
-#endif
-  tparams.ProcNumUpdates = Mmin(GlbNumUpdates, (4*tparams.LocalTableSize));
   /* works for both PowerofTwo and AnyNodes */
   NumUpdates = Mmin((tparams.ProcNumUpdates*tparams.NumProcs), (s64Int)NumUpdates_Default);
 #endif
@@ -791,24 +846,43 @@ HPCC_MPIRandomAccess(HPCC_Params *params) {
         fprintf( outFile, "PE Main table size = (2^" FSTR64 ")/%d  = " FSTR64 " words/PE MAX\n",
                  tparams.logTableSize, tparams.NumProcs, tparams.LocalTableSize);
 
+    fprintf( outFile, "Generator = %s\n", HPCC_RandomAccessGeneratorName( tparams.Generator ) );
     fprintf( outFile, "Default number of updates (RECOMMENDED) = " FSTR64 "\n", NumUpdates_Default);
 #ifdef RA_TIME_BOUND
-    fprintf( outFile, "Number of updates EXECUTED = " FSTR64 " (for a TIME BOUND of %.2f secs)\n",
-             NumUpdates, timeBound);
-#endif
-    params->MPIRandomAccess_ExeUpdates = NumUpdates;
-    params->MPIRandomAccess_TimeBound = timeBound;
+    if (timeBound > 0.0)
+      fprintf( outFile, "Number of updates EXECUTED = " FSTR64 " (for a TIME BOUND of %.2f secs)\n",
+               NumUpdates, timeBound);
+    else
+      fprintf( outFile, "Number of updates EXECUTED = " FSTR64 " (no TIME BOUND)\n", NumUpdates);
+    if (sampleRounds > 0)
+      fprintf( outFile, "Predicted time = %.2f secs (%d sampling round%s)\n", predictedTime,
+               sampleRounds, sampleRounds > 1 ? "s" : "" );
+#endif
+    *res->ExeUpdates = NumUpdates;
+    *res->TimeBound = timeBound;
+    *res->PredictedTime = predictedTime;
   }
 
   /* Initialize main table */
   for (i=0; i<tparams.LocalTableSize; i++)
     HPCC_Table[i] = i + tparams.GlobalStartMyProc;
 
+  HPCC_RandomAccessTableReport( params, HPCC_Table, 0 == tparams.MyProc ? outFile : NULL );
+
   MPI_Barrier( MPI_COMM_WORLD );
 
   CPUTime = -CPUSEC();
   RealTime = -RTSEC();
 
+#ifndef HPCC_RA_STDALG
+  if (HPCC_RA_LCG == tparams.Generator) {
+    if (PowerofTwo) {
+      HPCC_Power2NodesMPIRandomAccessUpdate_LCG( tparams );
+    } else {
+      HPCC_AnyNodesMPIRandomAccessUpdate_LCG( tparams );
+    }
+  } else
+#endif
   if (PowerofTwo) {
     Power2NodesMPIRandomAccessUpdate( tparams );
   } else {
@@ -824,10 +898,12 @@ HPCC_MPIRandomAccess(HPCC_Params *params) {
 
   /* Print timing results */
   if (tparams.MyProc == 0){
-    params->MPIRandomAccess_time = RealTime;
+    *res->time = RealTime;
     *GUPs = 1e-9*NumUpdates / RealTime;
     fprintf( outFile, "CPU time used = %.6f seconds\n", CPUTime );
     fprintf( outFile, "Real time used = %.6f seconds\n", RealTime );
+    if (predictedTime > 0.0)
+      fprintf( outFile, "Real time used / predicted time = %.2f\n", RealTime / predictedTime );
     fprintf( outFile, "%.9f Billion(10^9) Updates    per second [GUP/s]\n",
              *GUPs );
     fprintf( outFile, "%.9f Billion(10^9) Updates/PE per second [GUP/s]\n",
@@ -845,54 +921,43 @@ HPCC_MPIRandomAccess(HPCC_Params *params) {
   CPUTime = -CPUSEC();
   RealTime = -RTSEC();
 
-  if (PowerofTwo) {
-    HPCC_Power2NodesMPIRandomAccessCheck( tparams, &NumErrors );
-  }
-  else {
-    HPCC_AnyNodesMPIRandomAccessCheck( tparams, &NumErrors );
-  }
-
-
-#ifdef LONG_IS_64BITS
-  MPI_Reduce( &NumErrors, &GlbNumErrors, 1, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD );
-#else
-  /* MPI 1.1 standard (obsolete at this point) doesn't define MPI_SUM
-    to work on `long long':
-    http://www.mpi-forum.org/docs/mpi-11-html/node78.html and
-    therefore LAM 6.5.6 chooses not to implement it (even though there
-    is code for it in LAM and for other reductions work OK,
-    e.g. MPI_MAX). MPICH 1.2.5 doesn't complain about MPI_SUM but it
-    doesn't have MPI_UNSIGNED_LONG_LONG (but has MPI_LONG_LONG_INT):
-    http://www.mpi-forum.org/docs/mpi-20-html/node84.htm So I need to
-    create a trivial summation operation. */
-  MPI_Op_create( Sum64, 1, &sum64 );
-  MPI_Reduce( &NumErrors, &GlbNumErrors, 1, tparams.dtype64, sum64, 0, MPI_COMM_WORLD );
-  MPI_Op_free( &sum64 );
-#endif
+  GlbNumErrors = MPIRandomAccessCheck( params, tparams, PowerofTwo, outFile );
 
   /* End timed section */
   CPUTime += CPUSEC();
   RealTime += RTSEC();
 
   if(tparams.MyProc == 0){
-    params->MPIRandomAccess_CheckTime = RealTime;
+    *res->CheckTime = RealTime;
     fprintf( outFile, "Verification:  CPU time used = %.6f seconds\n", CPUTime);
     fprintf( outFile, "Verification:  Real time used = %.6f seconds\n", RealTime);
     fprintf( outFile, "Found " FSTR64 " errors in " FSTR64 " locations (%s).\n",
              GlbNumErrors, tparams.TableSize, (GlbNumErrors <= 0.01*tparams.TableSize) ?
              "passed" : "failed");
     if (GlbNumErrors > 0.01*tparams.TableSize) params->Failure = 1;
-    params->MPIRandomAccess_Errors = (s64Int)GlbNumErrors;
-    params->MPIRandomAccess_ErrorsFraction = (double)GlbNumErrors / (double)tparams.TableSize;
-    params->MPIRandomAccess_Algorithm = HPCC_RA_ALGORITHM;
+    *res->Errors = (s64Int)GlbNumErrors;
+    *res->ErrorsFraction = (double)GlbNumErrors / (double)tparams.TableSize;
+    *res->Algorithm = HPCC_RA_ALGORITHM;
   }
   /* End verification phase */
 
+  /* Repeat the run with the alternative algorithms */
+  if (res->Rerun && params->RandomAccessRMA)
+    MPIRandomAccessRerun( params, tparams, PowerofTwo, NumUpdates, outFile,
+                          HPCC_RMAMPIRandomAccessUpdate, "One-sided",
+                          &params->MPIRandomAccess_RMA_GUPs, &params->MPIRandomAccess_RMA_time,
+                          &params->MPIRandomAccess_RMA_Errors );
+  if (res->Rerun && params->RandomAccessHierarchical)
+    MPIRandomAccessRerun( params, tparams, PowerofTwo, NumUpdates, outFile,
+                          HPCC_NodeMPIRandomAccessUpdate, "Node-aggregated",
+                          &params->MPIRandomAccess_Node_GUPs, &params->MPIRandomAccess_Node_time,
+                          &params->MPIRandomAccess_Node_Errors );
+
 
   /* Deallocate memory (in reverse order of allocation which should
      help fragmentation) */
 
-  HPCC_free( HPCC_Table );
+  HPCC_RandomAccessTableFree( params, HPCC_Table, tparams.LocalTableSize );
   free( tparams.finish_req );
   free( tparams.finish_statuses );
 
@@ -904,3 +969,41 @@ HPCC_MPIRandomAccess(HPCC_Params *params) {
 
   return 0;
 }
+
+int
+HPCC_MPIRandomAccess(HPCC_Params *params) {
+  MPIRandomAccessResults res;
+
+  res.N = &params->MPIRandomAccess_N;
+  res.ExeUpdates = &params->MPIRandomAccess_ExeUpdates;
+  res.Errors = &params->MPIRandomAccess_Errors;
+  res.GUPs = &params->MPIRandomAccess_GUPs;
+  res.time = &params->MPIRandomAccess_time;
+  res.CheckTime = &params->MPIRandomAccess_CheckTime;
+  res.TimeBound = &params->MPIRandomAccess_TimeBound;
+  res.PredictedTime = &params->MPIRandomAccess_PredictedTime;
+  res.ErrorsFraction = &params->MPIRandomAccess_ErrorsFraction;
+  res.Algorithm = &params->MPIRandomAccess_Algorithm;
+  res.Rerun = 1;
+
+  return MPIRandomAccessRun( params, HPCC_RandomAccessGenerator( params ), &res );
+}
+
+int
+HPCC_MPIRandomAccess_LCG(HPCC_Params *params) {
+  MPIRandomAccessResults res;
+
+  res.N = &params->MPIRandomAccess_LCG_N;
+  res.ExeUpdates = &params->MPIRandomAccess_LCG_ExeUpdates;
+  res.Errors = &params->MPIRandomAccess_LCG_Errors;
+  res.GUPs = &params->MPIRandomAccess_LCG_GUPs;
+  res.time = &params->MPIRandomAccess_LCG_time;
+  res.CheckTime = &params->MPIRandomAccess_LCG_CheckTime;
+  res.TimeBound = &params->MPIRandomAccess_LCG_TimeBound;
+  res.PredictedTime = &params->MPIRandomAccess_LCG_PredictedTime;
+  res.ErrorsFraction = &params->MPIRandomAccess_LCG_ErrorsFraction;
+  res.Algorithm = &params->MPIRandomAccess_LCG_Algorithm;
+  res.Rerun = 0;
+
+  return MPIRandomAccessRun( params, HPCC_RA_LCG, &res );
+}
@@ -140,7 +140,7 @@ HPCC_AnyNodesMPIRandomAccessUpdate_LCG(HPCC_RandomAccess_tabparams_t tparams) {
   data = (u64Int *) malloc(CHUNKBIG*sizeof(u64Int));
   send = (u64Int *) malloc(CHUNKBIG*sizeof(u64Int));
 
-  ran = HPCC_starts_LCG(4*tparams.GlobalStartMyProc);
+  ran = HPCC_RandomAccessSeed( HPCC_RA_LCG, 4*tparams.GlobalStartMyProc );
 
   offsets = (u64Int *) malloc((tparams.NumProcs+1)*sizeof(u64Int));
   MPI_Allgather(&tparams.GlobalStartMyProc,1,tparams.dtype64,offsets,1,tparams.dtype64,
@@ -154,7 +154,7 @@ HPCC_AnyNodesMPIRandomAccessUpdate_LCG(HPCC_RandomAccess_tabparams_t tparams) {
 
   for (iterate = 0; iterate < niterate; iterate++) {
     for (i = 0; i < CHUNK; i++) {
-      ran = LCG_MUL64 * ran + LCG_ADD64;
+      ran = HPCC_RA_LCG_STEP( ran );
       data[i] = ran;
     }
     ndata = CHUNK;
@@ -292,51 +292,12 @@ void sort_data(u64Int *source, u64Int *nomatch, u64Int *match, int number,
   *nmatch = counts[1];
 }
 
-/* Manual unrolling is a significant win if -Msafeptr is used -KDU */
+/* The updates are batched and their table entries prefetched by HPCC_RandomAccessApply, which
+   replaces the former manual unrolling by 8 */
 
 static
 void update_table(u64Int *data, u64Int *table, int number, int nglobalm1, u64Int nlocalm1) {
-  int i,dindex;
-  int div_num = number / 8;
-  int loop_total = div_num * 8;
-  u64Int index,index0,index1,index2,index3,index4,index5,index6,index7;
-  u64Int ltable0,ltable1,ltable2,ltable3,ltable4,ltable5,ltable6,ltable7;
-
-  for (i = 0; i < div_num; i++) {
-    dindex = i*8;
-
-    index0 = (data[dindex  ] >> nglobalm1) & nlocalm1;
-    index1 = (data[dindex+1] >> nglobalm1) & nlocalm1;
-    index2 = (data[dindex+2] >> nglobalm1) & nlocalm1;
-    index3 = (data[dindex+3] >> nglobalm1) & nlocalm1;
-    index4 = (data[dindex+4] >> nglobalm1) & nlocalm1;
-    index5 = (data[dindex+5] >> nglobalm1) & nlocalm1;
-    index6 = (data[dindex+6] >> nglobalm1) & nlocalm1;
-    index7 = (data[dindex+7] >> nglobalm1) & nlocalm1;
-    ltable0 = table[index0];
-    ltable1 = table[index1];
-    ltable2 = table[index2];
-    ltable3 = table[index3];
-    ltable4 = table[index4];
-    ltable5 = table[index5];
-    ltable6 = table[index6];
-    ltable7 = table[index7];
-
-    table[index0] = ltable0 ^ data[dindex];
-    table[index1] = ltable1 ^ data[dindex+1];
-    table[index2] = ltable2 ^ data[dindex+2];
-    table[index3] = ltable3 ^ data[dindex+3];
-    table[index4] = ltable4 ^ data[dindex+4];
-    table[index5] = ltable5 ^ data[dindex+5];
-    table[index6] = ltable6 ^ data[dindex+6];
-    table[index7] = ltable7 ^ data[dindex+7];
-  }
-
-  for (i = loop_total; i < number; i++) {
-    u64Int datum = data[i];
-    index = (datum >> nglobalm1) & nlocalm1;
-    table[index] ^= datum;
-  }
+  HPCC_RandomAccessApply( table, data, number, nglobalm1, nlocalm1, 0 );
 }
 
 void
@@ -362,7 +323,7 @@ HPCC_Power2NodesMPIRandomAccessUpdate_LCG(HPCC_RandomAccess_tabparams_t tparams)
     for (i = 0; i < tparams.logNumProcs; i++)
       recv[j][i] = (u64Int *) malloc(sizeof(u64Int)*RCHUNK);
 
-  ran = HPCC_starts_LCG(4*tparams.GlobalStartMyProc);
+  ran = HPCC_RandomAccessSeed( HPCC_RA_LCG, 4*tparams.GlobalStartMyProc );
 
   niterate = tparams.ProcNumUpdates / CHUNK;
   logTableLocal = tparams.logTableSize - tparams.logNumProcs;
@@ -374,7 +335,7 @@ HPCC_Power2NodesMPIRandomAccessUpdate_LCG(HPCC_RandomAccess_tabparams_t tparams)
   for (iterate = 0; iterate < niterate; iterate++) {
     iter_mod = iterate % PITER;
     for (i = 0; i < CHUNK; i++) {
-      ran = LCG_MUL64 * ran + LCG_ADD64;
+      ran = HPCC_RA_LCG_STEP( ran );
       data[i] = ran;
     }
     nkept = CHUNK;
@@ -137,7 +137,7 @@ HPCC_AnyNodesMPIRandomAccessUpdate_LCG(HPCC_RandomAccess_tabparams_t tparams) {
   data = (u64Int *) malloc(CHUNKBIG*sizeof(u64Int));
   send = (u64Int *) malloc(CHUNKBIG*sizeof(u64Int));
 
-  ran = HPCC_starts_LCG(4*tparams.GlobalStartMyProc);
+  ran = HPCC_RandomAccessSeed( HPCC_RA_LCG, 4*tparams.GlobalStartMyProc );
 
   offsets = (u64Int *) malloc((tparams.NumProcs+1)*sizeof(u64Int));
   MPI_Allgather(&tparams.GlobalStartMyProc,1,tparams.dtype64,offsets,1,tparams.dtype64,
@@ -151,7 +151,7 @@ HPCC_AnyNodesMPIRandomAccessUpdate_LCG(HPCC_RandomAccess_tabparams_t tparams) {
 
   for (iterate = 0; iterate < niterate; iterate++) {
     for (i = 0; i < CHUNK; i++) {
-      ran = LCG_MUL64 * ran + LCG_ADD64;
+      ran = HPCC_RA_LCG_STEP( ran );
       data[i] = ran;
     }
     ndata = CHUNK;
@@ -254,7 +254,7 @@ HPCC_Power2NodesMPIRandomAccessUpdate_LCG(HPCC_RandomAccess_tabparams_t tparams)
   data = (u64Int *) malloc(CHUNKBIG*sizeof(u64Int));
   send = (u64Int *) malloc(CHUNKBIG*sizeof(u64Int));
 
-  ran = HPCC_starts_LCG(4*tparams.GlobalStartMyProc);
+  ran = HPCC_RandomAccessSeed( HPCC_RA_LCG, 4*tparams.GlobalStartMyProc );
 
   niterate = tparams.ProcNumUpdates / CHUNK;
   logTableLocal = tparams.logTableSize - tparams.logNumProcs;
@@ -265,7 +265,7 @@ HPCC_Power2NodesMPIRandomAccessUpdate_LCG(HPCC_RandomAccess_tabparams_t tparams)
 
   for (iterate = 0; iterate < niterate; iterate++) {
     for (i = 0; i < CHUNK; i++) {
-      ran = LCG_MUL64 * ran + LCG_ADD64;
+      ran = HPCC_RA_LCG_STEP( ran );
       data[i] = ran;
     }
     ndata = CHUNK;
@@ -0,0 +1,245 @@
+/* -*- mode: C; tab-width: 2; indent-tabs-mode: nil; -*- */
+
+/*
+ * Hierarchical (node-aggregated) variant of the MPI RandomAccess update.
+ *
+ * In the standard algorithm every process sends small messages directly to
+ * every other process so the number of messages grows with the number of
+ * processes.  Here the processes of a node (MPI_Comm_split_type with
+ * MPI_COMM_TYPE_SHARED) exchange updates through an MPI-3 shared memory
+ * window and only one leader per node communicates over the network:
+ *
+ *  1. every process generates up to LOCAL_BUFFER_SIZE updates into its
+ *     outbox in the shared window (the look-ahead allowed by the rules);
+ *  2. the leader sorts the updates of all processes of its node by
+ *     destination node and exchanges them with the other leaders with
+ *     MPI_Alltoallv;
+ *  3. the leader sorts the received updates by destination process and
+ *     copies them into the inboxes of the processes of its node, which apply
+ *     them to their part of the table.  An inbox holds NODE_INBOX_SIZE
+ *     updates so step 3 is repeated if more updates arrived for a process.
+ *
+ * The shared window is accessed with load/store in a single passive target
+ * epoch; MPI_Win_sync and a barrier on the node communicator order the
+ * accesses between the steps.
+ */
+
+#include <hpcc.h>
+
+#include "RandomAccess.h"
+
+#if MPI_VERSION >= 3
+
+#define NODE_INBOX_SIZE (4*LOCAL_BUFFER_SIZE)
+
+/* layout of the segment of every process in the shared window */
+#define NODE_OUT_COUNT 0
+#define NODE_OUT       1
+#define NODE_IN_COUNT  (NODE_OUT + LOCAL_BUFFER_SIZE)
+#define NODE_IN        (NODE_IN_COUNT + 1)
+#define NODE_SEGMENT   (NODE_IN + NODE_INBOX_SIZE)
+
+static int
+WhichPe(HPCC_RandomAccess_tabparams_t *tparams, u64Int Ran) {
+  u64Int GlobalOffset = (Ran >> HPCC_RA_SHIFT( tparams->Generator, tparams->logTableSize )) &
+    (tparams->TableSize-1);
+
+  if (GlobalOffset < tparams->Top)
+    return (int)( GlobalOffset / (tparams->MinLocalTableSize + 1) );
+  return (int)( (GlobalOffset - tparams->Remainder) / tparams->MinLocalTableSize );
+}
+
+/* Orders `n' updates by the key (destination node or local process) of their destination process
+   with a counting sort; `count' has `nkeys' entries and `displ' nkeys+1. */
+static void
+SortUpdates(HPCC_RandomAccess_tabparams_t *tparams, u64Int *src, int n, u64Int *dst, int *key,
+  int nkeys, int *count, int *displ) {
+  int i, k;
+
+  for (k = 0; k < nkeys; k++) count[k] = 0;
+  for (i = 0; i < n; i++) count[key[WhichPe( tparams, src[i] )]]++;
+
+  for (displ[0] = 0, k = 0; k < nkeys; k++) displ[k+1] = displ[k] + count[k];
+
+  for (k = 0; k < nkeys; k++) count[k] = 0;
+  for (i = 0; i < n; i++) {
+    k = key[WhichPe( tparams, src[i] )];
+    dst[displ[k] + count[k]++] = src[i];
+  }
+}
+
+int
+HPCC_NodeMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
+  s64Int i, Rounds, MyRounds;
+  int j, k, l, n, failed, anyFailed, NodeRank, NodeSize, dispUnit;
+  int NumNodes = 0, MyNode = 0, Steps = 0;
+  int *NodeOf, *LocalOf, *ids, *sendCounts, *sendDispls, *recvCounts, *recvDispls, *inCounts,
+    *inDispls;
+  u64Int State, *Segment, **Segments, *sendBuffer = NULL, *recvBuffer = NULL, *inBuffer = NULL;
+  s64Int recvCapacity = 0;
+  MPI_Aint size;
+  MPI_Comm NodeComm, LeaderComm;
+  MPI_Win win;
+  MPI_Errhandler errh;
+
+  MPI_Comm_split_type( MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, tparams.MyProc, MPI_INFO_NULL,
+                       &NodeComm );
+  MPI_Comm_rank( NodeComm, &NodeRank );
+  MPI_Comm_size( NodeComm, &NodeSize );
+
+  /* the shared window may not be supported by the available transports */
+  MPI_Comm_get_errhandler( NodeComm, &errh );
+  MPI_Comm_set_errhandler( NodeComm, MPI_ERRORS_RETURN );
+  failed = MPI_SUCCESS != MPI_Win_allocate_shared( NODE_SEGMENT * sizeof(u64Int), sizeof(u64Int),
+                                                   MPI_INFO_NULL, NodeComm, &Segment, &win );
+  MPI_Comm_set_errhandler( NodeComm, errh );
+  MPI_Errhandler_free( &errh );
+
+  MPI_Allreduce( &failed, &anyFailed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD );
+  if (anyFailed) {
+    /* the processes that did allocate the window take part in freeing it */
+    if (! failed) MPI_Win_free( &win );
+    MPI_Comm_free( &NodeComm );
+    return -1;
+  }
+
+  MPI_Comm_split( MPI_COMM_WORLD, NodeRank ? MPI_UNDEFINED : 0, tparams.MyProc, &LeaderComm );
+
+  /* number the nodes by their leaders and find the node and local rank of every process */
+  if (0 == NodeRank) {
+    MPI_Comm_rank( LeaderComm, &MyNode );
+    MPI_Comm_size( LeaderComm, &NumNodes );
+  }
+  MPI_Bcast( &MyNode, 1, MPI_INT, 0, NodeComm );
+  MPI_Bcast( &NumNodes, 1, MPI_INT, 0, NodeComm );
+
+  NodeOf = XMALLOC( int, tparams.NumProcs );
+  LocalOf = XMALLOC( int, tparams.NumProcs );
+  ids = XMALLOC( int, 2 * tparams.NumProcs );
+  Segments = XMALLOC( u64Int *, NodeSize );
+  sendCounts = XMALLOC( int, 4 * NumNodes + 2 );
+  sendDispls = sendCounts + NumNodes;
+  recvCounts = sendDispls + NumNodes + 1;
+  recvDispls = recvCounts + NumNodes;
+  inCounts = XMALLOC( int, 2 * NodeSize + 1 );
+  inDispls = inCounts + NodeSize;
+
+  ids[2 * tparams.MyProc] = MyNode;
+  ids[2 * tparams.MyProc + 1] = NodeRank;
+  MPI_Allgather( MPI_IN_PLACE, 2, MPI_INT, ids, 2, MPI_INT, MPI_COMM_WORLD );
+  for (j = 0; j < tparams.NumProcs; j++) {
+    NodeOf[j] = ids[2 * j];
+    LocalOf[j] = ids[2 * j + 1];
+  }
+
+  for (l = 0; l < NodeSize; l++)
+    MPI_Win_shared_query( win, l, &size, &dispUnit, &Segments[l] );
+
+  if (0 == NodeRank) {
+    sendBuffer = XMALLOC( u64Int, NodeSize * LOCAL_BUFFER_SIZE );
+    inBuffer = XMALLOC( u64Int, NodeSize * LOCAL_BUFFER_SIZE );
+  }
+
+  /* all processes take part in every round until the last process is done */
+  MyRounds = (tparams.ProcNumUpdates + LOCAL_BUFFER_SIZE - 1) / LOCAL_BUFFER_SIZE;
+  MPI_Allreduce( &MyRounds, &Rounds, 1, tparams.dtype64, MPI_MAX, MPI_COMM_WORLD );
+
+  MPI_Win_lock_all( MPI_MODE_NOCHECK, win );
+
+  State = HPCC_RandomAccessSeed( tparams.Generator, 4 * tparams.GlobalStartMyProc );
+
+  for (i = 0; i < Rounds; i++) {
+    n = (int)Mmax( 0, Mmin( (s64Int)LOCAL_BUFFER_SIZE, tparams.ProcNumUpdates - i * LOCAL_BUFFER_SIZE ) );
+    HPCC_RandomAccessFill( tparams.Generator, &State, Segment + NODE_OUT, n );
+    Segment[NODE_OUT_COUNT] = n;
+
+    MPI_Win_sync( win );
+    MPI_Barrier( NodeComm );
+    MPI_Win_sync( win );
+
+    if (0 == NodeRank) {
+      /* gather the updates of the node and exchange them with the other leaders */
+      for (n = 0, l = 0; l < NodeSize; l++) {
+        for (j = 0; j < (int)Segments[l][NODE_OUT_COUNT]; j++)
+          inBuffer[n++] = Segments[l][NODE_OUT + j];
+      }
+      SortUpdates( &tparams, inBuffer, n, sendBuffer, NodeOf, NumNodes, sendCounts, sendDispls );
+
+      MPI_Alltoall( sendCounts, 1, MPI_INT, recvCounts, 1, MPI_INT, LeaderComm );
+      for (recvDispls[0] = 0, k = 0; k < NumNodes - 1; k++)
+        recvDispls[k+1] = recvDispls[k] + recvCounts[k];
+      n = recvDispls[NumNodes - 1] + recvCounts[NumNodes - 1];
+
+      if (n > recvCapacity) {
+        if (recvBuffer) free( recvBuffer );
+        recvCapacity = Mmax( n, 2 * recvCapacity );
+        recvBuffer = XMALLOC( u64Int, recvCapacity );
+        free( inBuffer );
+        inBuffer = XMALLOC( u64Int, Mmax( recvCapacity, NodeSize * LOCAL_BUFFER_SIZE ) );
+      }
+
+      MPI_Alltoallv( sendBuffer, sendCounts, sendDispls, tparams.dtype64,
+                     recvBuffer, recvCounts, recvDispls, tparams.dtype64, LeaderComm );
+
+      SortUpdates( &tparams, recvBuffer, n, inBuffer, LocalOf, NodeSize, inCounts, inDispls );
+
+      for (Steps = 0, l = 0; l < NodeSize; l++)
+        Steps = Mmax( Steps, (inCounts[l] + NODE_INBOX_SIZE - 1) / NODE_INBOX_SIZE );
+    }
+
+    MPI_Bcast( &Steps, 1, MPI_INT, 0, NodeComm );
+
+    /* fan the received updates out to the processes of the node */
+    for (k = 0; k < Steps; k++) {
+      if (0 == NodeRank) {
+        for (l = 0; l < NodeSize; l++) {
+          n = Mmax( 0, Mmin( NODE_INBOX_SIZE, inCounts[l] - k * NODE_INBOX_SIZE ) );
+          memcpy( Segments[l] + NODE_IN, inBuffer + inDispls[l] + k * NODE_INBOX_SIZE,
+                  n * sizeof(u64Int) );
+          Segments[l][NODE_IN_COUNT] = n;
+        }
+      }
+
+      MPI_Win_sync( win );
+      MPI_Barrier( NodeComm );
+      MPI_Win_sync( win );
+
+      HPCC_RandomAccessApply( HPCC_Table, Segment + NODE_IN, (int)Segment[NODE_IN_COUNT],
+                              HPCC_RA_SHIFT( tparams.Generator, tparams.logTableSize ),
+                              tparams.TableSize - 1, tparams.GlobalStartMyProc );
+
+      MPI_Win_sync( win );
+      MPI_Barrier( NodeComm );
+      MPI_Win_sync( win );
+    }
+  }
+
+  MPI_Win_unlock_all( win );
+
+  if (0 == NodeRank) {
+    if (recvBuffer) free( recvBuffer );
+    free( inBuffer );
+    free( sendBuffer );
+    MPI_Comm_free( &LeaderComm );
+  }
+  free( inCounts );
+  free( sendCounts );
+  free( Segments );
+  free( ids );
+  free( LocalOf );
+  free( NodeOf );
+
+  MPI_Win_free( &win );
+  MPI_Comm_free( &NodeComm );
+
+  return 0;
+}
+
+#else
+
+int
+HPCC_NodeMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
+  return -1;
+}
+
+#endif
@@ -0,0 +1,100 @@
+/* -*- mode: C; tab-width: 2; indent-tabs-mode: nil; -*- */
+
+/*
+ * One-sided variant of the MPI RandomAccess update.
+ *
+ * The local part of HPCC_Table is exposed through an MPI-3 window and every
+ * update is applied to its owner with MPI_Accumulate(MPI_BXOR), which makes
+ * the XOR atomic with respect to the updates coming from other processes.
+ * The processes stay in a single passive target epoch (MPI_Win_lock_all) and
+ * complete the outstanding accumulates with MPI_Win_flush_all after every
+ * batch of LOCAL_BUFFER_SIZE updates, so no process looks ahead more than
+ * the 1024 random stream samples allowed by the rules. Updates to the local
+ * part of the table go through the window as well: a plain store could race
+ * with an accumulate from another process to the same entry.
+ */
+
+#include <hpcc.h>
+
+#include "RandomAccess.h"
+
+#if MPI_VERSION >= 3
+
+/* Returns the first global index of the part of the table stored on `pe' */
+static u64Int
+GlobalStart(HPCC_RandomAccess_tabparams_t *tparams, int pe) {
+  if (pe < tparams->Remainder)
+    return (tparams->MinLocalTableSize + 1) * pe;
+  return tparams->MinLocalTableSize * pe + tparams->Remainder;
+}
+
+int
+HPCC_RMAMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
+  s64Int i, j, n;
+  int WhichPe, failed, anyFailed;
+  u64Int State, GlobalOffset;
+  u64Int Ranbuf[LOCAL_BUFFER_SIZE];
+  int shift = HPCC_RA_SHIFT( tparams.Generator, tparams.logTableSize );
+  MPI_Win win;
+  MPI_Info info;
+  MPI_Errhandler errh;
+
+  MPI_Info_create( &info );
+  /* all accumulates use the same operation so the MPI library may use hardware atomics */
+  MPI_Info_set( info, "accumulate_ops", "same_op" );
+  /* the window may not be supported by the available transports (e.g. for a single process) */
+  MPI_Comm_get_errhandler( MPI_COMM_WORLD, &errh );
+  MPI_Comm_set_errhandler( MPI_COMM_WORLD, MPI_ERRORS_RETURN );
+  failed = MPI_SUCCESS != MPI_Win_create( HPCC_Table, tparams.LocalTableSize * sizeof(u64Int),
+                                          sizeof(u64Int), info, MPI_COMM_WORLD, &win );
+  MPI_Comm_set_errhandler( MPI_COMM_WORLD, errh );
+  MPI_Errhandler_free( &errh );
+  MPI_Info_free( &info );
+
+  MPI_Allreduce( &failed, &anyFailed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD );
+  if (anyFailed) {
+    /* the processes that did create the window take part in freeing it */
+    if (! failed) MPI_Win_free( &win );
+    return -1;
+  }
+
+  MPI_Win_lock_all( MPI_MODE_NOCHECK, win );
+
+  State = HPCC_RandomAccessSeed( tparams.Generator, 4 * tparams.GlobalStartMyProc );
+
+  for (i = 0; i < tparams.ProcNumUpdates; i += n) {
+    n = Mmin( (s64Int)LOCAL_BUFFER_SIZE, tparams.ProcNumUpdates - i );
+
+    /* the origin buffer may not be modified until the batch is flushed */
+    HPCC_RandomAccessFill( tparams.Generator, &State, Ranbuf, (int)n );
+
+    for (j = 0; j < n; j++) {
+      GlobalOffset = (Ranbuf[j] >> shift) & (tparams.TableSize-1);
+      if (GlobalOffset < tparams.Top)
+        WhichPe = (int)( GlobalOffset / (tparams.MinLocalTableSize + 1) );
+      else
+        WhichPe = (int)( (GlobalOffset - tparams.Remainder) / tparams.MinLocalTableSize );
+
+      MPI_Accumulate( Ranbuf + j, 1, tparams.dtype64, WhichPe,
+                      (MPI_Aint)(GlobalOffset - GlobalStart( &tparams, WhichPe )), 1, tparams.dtype64,
+                      MPI_BXOR, win );
+    }
+
+    MPI_Win_flush_all( win );
+  }
+
+  MPI_Win_unlock_all( win );
+
+  MPI_Win_free( &win );
+
+  return 0;
+}
+
+#else
+
+int
+HPCC_RMAMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
+  return -1;
+}
+
+#endif
@@ -137,7 +137,7 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   data = (u64Int *) malloc(CHUNKBIG*sizeof(u64Int));
   send = (u64Int *) malloc(CHUNKBIG*sizeof(u64Int));
 
-  ran = HPCC_starts(4*tparams.GlobalStartMyProc);
+  ran = HPCC_RandomAccessSeed( HPCC_RA_POLY, 4*tparams.GlobalStartMyProc );
 
   offsets = (u64Int *) malloc((tparams.NumProcs+1)*sizeof(u64Int));
   MPI_Allgather(&tparams.GlobalStartMyProc,1,tparams.dtype64,offsets,1,tparams.dtype64,
@@ -151,7 +151,7 @@ AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 
   for (iterate = 0; iterate < niterate; iterate++) {
     for (i = 0; i < CHUNK; i++) {
-      ran = (ran << 1) ^ ((s64Int) ran < ZERO64B ? POLY : ZERO64B);
+      ran = HPCC_RA_POLY_STEP( ran );
       data[i] = ran;
     }
     ndata = CHUNK;
@@ -254,7 +254,7 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
   data = (u64Int *) malloc(CHUNKBIG*sizeof(u64Int));
   send = (u64Int *) malloc(CHUNKBIG*sizeof(u64Int));
 
-  ran = HPCC_starts(4*tparams.GlobalStartMyProc);
+  ran = HPCC_RandomAccessSeed( HPCC_RA_POLY, 4*tparams.GlobalStartMyProc );
 
   niterate = tparams.ProcNumUpdates / CHUNK;
   logTableLocal = tparams.logTableSize - tparams.logNumProcs;
@@ -264,7 +264,7 @@ Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams) {
 
   for (iterate = 0; iterate < niterate; iterate++) {
     for (i = 0; i < CHUNK; i++) {
-      ran = (ran << 1) ^ ((s64Int) ran < ZERO64B ? POLY : ZERO64B);
+      ran = HPCC_RA_POLY_STEP( ran );
       data[i] = ran;
     }
     ndata = CHUNK;
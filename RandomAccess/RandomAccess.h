@@ -1,20 +1,19 @@
 /* -*- mode: C; tab-width: 2; indent-tabs-mode: nil; -*- */
 
-/* Random number generator */
-#ifdef LONG_IS_64BITS
-#define POLY 0x0000000000000007UL
-#define PERIOD 1317624576693539401L
-#else
-#define POLY 0x0000000000000007ULL
-#define PERIOD 1317624576693539401LL
-#endif
+#include "generator.h"
 
 /* Macros for timing */
 #define CPUSEC() (HPL_timer_cputime())
 #define RTSEC() (MPI_Wtime())
 
-extern u64Int HPCC_starts (s64Int);
-extern u64Int HPCC_starts_LCG (s64Int);
+/* Number of updates whose table entries are prefetched together by HPCC_RandomAccessApply */
+#define HPCC_RA_BATCH 16
+
+extern void HPCC_RandomAccessApply(u64Int *table, u64Int *data, int number, int shift, u64Int mask,
+  u64Int offset);
+extern u64Int *HPCC_RandomAccessTableAlloc(HPCC_Params *params, u64Int size);
+extern void HPCC_RandomAccessTableFree(HPCC_Params *params, u64Int *table, u64Int size);
+extern void HPCC_RandomAccessTableReport(HPCC_Params *params, u64Int *table, FILE *outFile);
 
 #define WANT_MPI2_TEST 0
 
@@ -38,12 +37,8 @@ extern u64Int HPCC_starts_LCG (s64Int);
 #define MAX_RECV					1
 #endif
 
-#define LCG_MUL64 6364136223846793005ULL
-#define LCG_ADD64 1
-
 extern u64Int *HPCC_Table;
 
-extern u64Int LocalSendBuffer[LOCAL_BUFFER_SIZE];
 extern u64Int LocalRecvBuffer[MAX_RECV*LOCAL_BUFFER_SIZE];
 
 typedef struct HPCC_RandomAccess_tabparams_s {
@@ -63,21 +58,30 @@ typedef struct HPCC_RandomAccess_tabparams_s {
 
   int logNumProcs, NumProcs, MyProc;
 
+  int Generator; /* generator of the updates: HPCC_RA_POLY, HPCC_RA_LCG, or HPCC_RA_PHILOX */
+
   int Remainder; /* TableSize % NumProcs */
 } HPCC_RandomAccess_tabparams_t;
 
 extern void AnyNodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams);
 extern void Power2NodesMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams);
+/* the Sandia algorithms (RA_SANDIA_NOPT, RA_SANDIA_OPT2) have separate updates for the LCG */
 extern void HPCC_AnyNodesMPIRandomAccessUpdate_LCG(HPCC_RandomAccess_tabparams_t tparams);
 extern void HPCC_Power2NodesMPIRandomAccessUpdate_LCG(HPCC_RandomAccess_tabparams_t tparams);
+/* one-sided update with MPI-3 RMA; returns -1 if the MPI library cannot create the window */
+extern int HPCC_RMAMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams);
+/* update through node leaders with MPI-3 shared memory; returns -1 if it is not supported */
+extern int HPCC_NodeMPIRandomAccessUpdate(HPCC_RandomAccess_tabparams_t tparams);
 
 extern int HPCC_RandomAccess(HPCC_Params *params, int doIO, double *GUPs, int *failure);
 extern int HPCC_RandomAccess_LCG(HPCC_Params *params, int doIO, double *GUPs, int *failure);
 
 extern void HPCC_Power2NodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64Int *NumErrors);
 extern void HPCC_AnyNodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64Int *NumErrors);
-extern void HPCC_Power2NodesMPIRandomAccessCheck_LCG(HPCC_RandomAccess_tabparams_t tparams, s64Int *NumErrors);
-extern void HPCC_AnyNodesMPIRandomAccessCheck_LCG(HPCC_RandomAccess_tabparams_t tparams, s64Int *NumErrors);
+extern void HPCC_BulkMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64Int chunk,
+  s64Int *NumErrors);
+extern void HPCC_MPIRandomAccessVerify(HPCC_Params *params, HPCC_RandomAccess_tabparams_t tparams,
+  int PowerofTwo, FILE *outFile, s64Int *NumErrors);
 
 #if defined( RA_SANDIA_NOPT )
 #define HPCC_RA_ALGORITHM 1
@@ -1,18 +1,15 @@
 /* buckets.c
  *
  * Each process (PE) has a set of buckets, one for each possible
- * destination PE. Each set of buckets is implementated as an
- * array of objects, one for each destination PE, where each object
- * keeps the number of updates currently in the bucket and a pointer
- * to a list of updates.
- * The motivation for using lists (instead of fixed size buckets)
- * is to keep the memory requirements low as the number of processes
- * increase. To avoid the overheads of allocating memory dynamically,
- * a pool of memory is previously allocated and objetcs are
- * allocated/returned from/to this pool (see pool.c for details).
+ * destination PE. Each bucket keeps its updates in a contiguous
+ * array that is grown (doubled) when it becomes full, so appending
+ * an update is O(1) and a bucket can be sent as it is.
  *
- * An auxiliary data structure keeps the local buckets ordered
- * according to the number of updates of each bucket (see heap.c).
+ * To find the largest bucket, buckets with the same (non-zero)
+ * number of updates are kept in doubly linked lists indexed by that
+ * number (a bucket queue): adding an update moves the bucket to the
+ * next list and the largest bucket is the head of the highest
+ * non-empty list.
  *
  */
 
@@ -20,112 +17,145 @@
 #include <hpcc.h>
 #include "RandomAccess.h"
 #include "buckets.h"
-#include "heap.h"
-#include "pool.h"
 
-/* memory pool for updates */
-static POOL *Update_Pool;
+#define NOT_A_PE (-1)
+
+static int *Heads;              /* Heads[n]: a PE whose bucket has n updates */
+static int MaxUpdates;          /* number of updates in the largest bucket */
+static int MaxNumUpdates;       /* largest number of updates a bucket may hold */
+static u64Int *Spare;           /* array given to the next bucket that is taken */
+static int SpareCapacity;
+
+/* Aborts the run if an allocation in `func' failed, as the old pool of update objects did */
+static void
+CheckAlloc(void *ptr, const char *func)
+{
+  if (! ptr) {
+    fprintf(stdout,"Malloc fails in %s\n", func);
+    MPI_Abort( MPI_COMM_WORLD, -1 );
+  }
+}
+
+static void
+Unlink(Bucket_Ptr Buckets, int pe, int n)
+{
+  Bucket_Ptr bucket = Buckets + pe;
+
+  if (bucket->prev != NOT_A_PE) Buckets[bucket->prev].next = bucket->next;
+  else Heads[n] = bucket->next;
+  if (bucket->next != NOT_A_PE) Buckets[bucket->next].prev = bucket->prev;
+}
+
+static void
+Link(Bucket_Ptr Buckets, int pe, int n)
+{
+  Bucket_Ptr bucket = Buckets + pe;
+
+  bucket->prev = NOT_A_PE;
+  bucket->next = Heads[n];
+  if (Heads[n] != NOT_A_PE) Buckets[Heads[n]].prev = pe;
+  Heads[n] = pe;
+}
 
 Bucket_Ptr HPCC_InitBuckets(int numPEs, int maxNumUpdates)
 {
   Bucket_Ptr Buckets;
-  int i;
+  int i, capacity;
+
+  /* start with twice the average share of the pending updates */
+  capacity = Mmin( maxNumUpdates, Mmax( 8, 2 * maxNumUpdates / numPEs ) );
 
   Buckets = (Bucket_Ptr) malloc (numPEs * sizeof(Bucket_T));
+  CheckAlloc( Buckets, "HPCC_InitBuckets" );
   for (i=0; i<numPEs; i++) {
     Buckets[i].numUpdates = 0;
-    Buckets[i].updateList = NULL_UPDATE_PTR;
+    Buckets[i].capacity = capacity;
+    Buckets[i].updates = XMALLOC( u64Int, capacity );
+    CheckAlloc( Buckets[i].updates, "HPCC_InitBuckets" );
+    Buckets[i].prev = Buckets[i].next = NOT_A_PE;
   }
 
-  /* initialize memory pool for updates */
-  Update_Pool = HPCC_PoolInit (maxNumUpdates, sizeof(Update_T));
+  MaxNumUpdates = maxNumUpdates;
+  MaxUpdates = 0;
+  Heads = XMALLOC( int, maxNumUpdates + 1 );
+  CheckAlloc( Heads, "HPCC_InitBuckets" );
+  for (i=0; i<=maxNumUpdates; i++)
+    Heads[i] = NOT_A_PE;
 
-  /* initialize heap of PE's with pending updates */
-  HPCC_ra_Heap_Init(numPEs);
+  SpareCapacity = capacity;
+  Spare = XMALLOC( u64Int, capacity );
+  CheckAlloc( Spare, "HPCC_InitBuckets" );
 
   return(Buckets);
 }
 
 
+/* The caller never has more than `maxNumUpdates' pending updates in all buckets */
 void HPCC_InsertUpdate(u64Int ran, int pe, Bucket_Ptr Buckets)
 {
-
-  Update_Ptr update;
   Bucket_Ptr bucket;
-  int numUpdates;
+  u64Int *updates;
+  int numUpdates, capacity;
 
   bucket = Buckets + pe; /* bucket = &(Buckets[pe]); */
-  update = (Update_T*) HPCC_PoolGetObj(Update_Pool);
-  update->value = ran;
-  update->forward = bucket->updateList;
-  bucket->updateList = update;
-  bucket->numUpdates++;
-
   numUpdates = bucket->numUpdates;
-  if (numUpdates == 1) {  /* this is the first update for this PE since last send */
-    HPCC_ra_Heap_Insert (pe, numUpdates);
-  }
-  else { /* PE already in heap, just increment number of updates */
-    HPCC_ra_Heap_IncrementKey(pe);
+
+  if (numUpdates == bucket->capacity) {
+    capacity = Mmin( 2 * bucket->capacity, MaxNumUpdates );
+    updates = (u64Int *) realloc( bucket->updates, capacity * sizeof(u64Int) );
+    CheckAlloc( updates, "HPCC_InsertUpdate" );
+    bucket->updates = updates;
+    bucket->capacity = capacity;
   }
 
-}
+  bucket->updates[numUpdates] = ran;
 
+  if (numUpdates > 0) /* PE is already in the queue */
+    Unlink( Buckets, pe, numUpdates );
+  bucket->numUpdates = ++numUpdates;
+  Link( Buckets, pe, numUpdates );
 
+  if (numUpdates > MaxUpdates) MaxUpdates = numUpdates;
+}
 
-int HPCC_GetUpdates(Bucket_Ptr Buckets, u64Int *bufferPtr, int bufferSize, int *peUpdates)
-{
 
-  int pe;
+/* Empties the largest bucket and returns its array of updates without copying them.  The array
+ * has to stay untouched until the next call (i.e. until the send from it has completed) since
+ * it is then given to another bucket.  There has to be at least one pending update. */
+u64Int *HPCC_TakeUpdates(Bucket_Ptr Buckets, int *pe, int *peUpdates)
+{
   Bucket_Ptr bucket;
-  Update_Ptr update, tmp;
-  u64Int *buffer;
+  u64Int *updates;
+  int capacity;
 
-  HPCC_ra_Heap_ExtractMax (&pe, peUpdates);
-  bucket = Buckets + pe; /* bucket = &(Buckets[pe]); */
+  *pe = Heads[MaxUpdates];
+  *peUpdates = MaxUpdates;
+  bucket = Buckets + *pe;
 
-  /* copy updates to buffer */
-  update = bucket->updateList;
-  buffer = bufferPtr;
-  while (update != NULL_UPDATE_PTR) {
-    *buffer = (u64Int)(update->value);
-    buffer ++;
-    tmp = update;
-    update = update->forward;
-    HPCC_PoolReturnObj(Update_Pool, tmp);
-  }
-
-  if (buffer - bufferPtr > bufferSize)
-    buffer --;
+  Unlink( Buckets, *pe, MaxUpdates );
+  while (MaxUpdates > 0 && Heads[MaxUpdates] == NOT_A_PE)
+    MaxUpdates--;
 
-  *peUpdates = bucket->numUpdates;
+  updates = bucket->updates;
+  capacity = bucket->capacity;
+  bucket->updates = Spare;
+  bucket->capacity = SpareCapacity;
   bucket->numUpdates = 0;
-  bucket->updateList = NULL_UPDATE_PTR;
-
-  return(pe);
+  Spare = updates;
+  SpareCapacity = capacity;
 
+  return(updates);
 }
 
 
 void HPCC_FreeBuckets (Bucket_Ptr Buckets, int numPEs)
 {
-
-  Update_Ptr ptr1, ptr2;
   int i;
 
-  HPCC_ra_Heap_Free();
+  for (i = 0; i < numPEs; i ++)
+    free( Buckets[i].updates );
 
-  for (i = 0; i < numPEs; i ++) {
-    ptr1 = Buckets[i].updateList;
-    while (ptr1 != NULL_UPDATE_PTR) {
-      ptr2 = ptr1;
-      ptr1 = ptr1->forward;
-      HPCC_PoolReturnObj(Update_Pool, ptr2);
-    }
-  }
-
-  HPCC_PoolFree(Update_Pool);
-  free(Update_Pool);
+  free( Spare );
+  free( Heads );
   free (Buckets);
-
 }
@@ -41,20 +41,35 @@
  * of GUPS.  The inner loop should easily be vectorized by compilers
  * with such support.
  *
- * This core is used by both the single_cpu and star_single_cpu tests.
+ * This core is used by both the single_cpu and star_single_cpu tests and, with
+ * the LCG generator, by their _lcg variants.
  */
 
 #include <hpcc.h>
 #include "RandomAccess.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /* Number of updates to table (suggested: 4x number of table entries) */
 #define NUPDATE (4 * TableSize)
 
+/* Number of independent update streams: 128 or, for more threads, one per thread (rounded up
+   to a power of 2 so that it divides NUPDATE) */
+static int
+RandomAccessStreams(int threads) {
+  int streams;
+  for (streams = 128; streams < threads; streams <<= 1)
+    ; /* EMPTY */
+  return streams;
+}
+
 static void
-RandomAccessUpdate(u64Int TableSize, u64Int *Table) {
-  u64Int i;
-  u64Int ran[128];              /* Current random numbers */
-  int j;
+RandomAccessUpdate(int gen, u64Int logTableSize, u64Int TableSize, u64Int *Table, int threads,
+  int atomic) {
+  int streams = RandomAccessStreams( threads ), shift = HPCC_RA_SHIFT( gen, logTableSize );
+  u64Int perStream = NUPDATE / streams;
 
   /* Perform updates to main table.  The scalar equivalent is:
    *
@@ -64,31 +79,80 @@ RandomAccessUpdate(u64Int TableSize, u64Int *Table) {
    *       ran = (ran << 1) ^ (((s64Int) ran < 0) ? POLY : 0);
    *       table[ran & (TableSize-1)] ^= ran;
    *     }
+   *
+   * for the POLY generator (see generator.h for the others).
+   *
+   * Every thread owns a contiguous slice of the streams for the whole run so that there is a
+   * single parallel region.  The new values of all its streams are applied together with
+   * prefetching (see HPCC_RandomAccessApply).  Concurrent updates of the same table entry may
+   * be lost unless `atomic' is set; the rules allow for 1% of errors.
+   *
+   * A thread runs at most 128 streams at a time: when OpenMP grants fewer threads than
+   * requested, its slice is done in groups of 128 streams.
    */
-  for (j=0; j<128; j++)
-    ran[j] = HPCC_starts ((NUPDATE/128) * j);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads)
+#endif
+  {
+    u64Int i, ran[128];         /* Current random numbers */
+    u64Int state[128];          /* Generator states of the streams */
+    int j, lo, hi, end, count, me = 0, nt = 1;
 
-  for (i=0; i<NUPDATE/128; i++) {
-/* #pragma ivdep */
 #ifdef _OPENMP
-#pragma omp parallel for
+    me = omp_get_thread_num();
+    nt = omp_get_num_threads();
 #endif
-    for (j=0; j<128; j++) {
-      ran[j] = (ran[j] << 1) ^ ((s64Int) ran[j] < 0 ? POLY : 0);
-      Table[ran[j] & (TableSize-1)] ^= ran[j];
+
+    end = (int)((s64Int)streams * (me + 1) / nt);
+
+    for (lo = (int)((s64Int)streams * me / nt); lo < end; lo = hi) {
+      hi = end - lo > 128 ? lo + 128 : end;
+      count = hi - lo;
+
+      for (j=0; j<count; j++)
+        state[j] = HPCC_RandomAccessSeed( gen, perStream * (lo + j) );
+
+      if (atomic) {
+        for (i=0; i<perStream; i++)
+          for (j=0; j<count; j++) {
+            ran[j] = HPCC_RA_NEXT( gen, state[j] );
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+            Table[(ran[j] >> shift) & (TableSize-1)] ^= ran[j];
+          }
+      } else {
+        for (i=0; i<perStream; i++) {
+          for (j=0; j<count; j++)
+            ran[j] = HPCC_RA_NEXT( gen, state[j] );
+          HPCC_RandomAccessApply( Table, ran, count, shift, TableSize-1, 0 );
+        }
+      }
     }
   }
 }
 
-int
-HPCC_RandomAccess(HPCC_Params *params, int doIO, double *GUPs, int *failure) {
+/* Returns the number of threads to use: RA_Threads or all available if it is not positive */
+static int
+RandomAccessThreads(HPCC_Params *params) {
+#ifdef _OPENMP
+  return params->RandomAccessThreads > 0 ? params->RandomAccessThreads : omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+/* Runs the benchmark with generator `gen' and stores the table size in `N' */
+static int
+RandomAccessRun(HPCC_Params *params, int gen, int doIO, double *GUPs, int *failure, s64Int *N) {
   u64Int i;
   u64Int temp;
   double cputime;               /* CPU time to update table */
   double realtime;              /* Real time to update table */
-  double totalMem;
+  double totalMem, sweepTime;
   u64Int *Table;
   u64Int logTableSize, TableSize;
+  int t, threads = RandomAccessThreads( params );
   FILE *outFile = NULL;
 
   if (doIO) {
@@ -110,7 +174,7 @@ HPCC_RandomAccess(HPCC_Params *params, int doIO, double *GUPs, int *failure) {
        totalMem *= 0.5, logTableSize++, TableSize <<= 1)
     ; /* EMPTY */
 
-  Table = HPCC_XMALLOC( u64Int, TableSize );
+  Table = HPCC_RandomAccessTableAlloc( params, TableSize );
   if (! Table) {
     if (doIO) {
       fprintf( outFile, "Failed to allocate memory for the update table (" FSTR64 ").\n", TableSize);
@@ -118,22 +182,40 @@ HPCC_RandomAccess(HPCC_Params *params, int doIO, double *GUPs, int *failure) {
     }
     return 1;
   }
-  params->RandomAccess_N = (s64Int)TableSize;
+  *N = (s64Int)TableSize;
 
   /* Print parameters for run */
   if (doIO) {
   fprintf( outFile, "Main table size   = 2^" FSTR64 " = " FSTR64 " words\n", logTableSize,TableSize);
   fprintf( outFile, "Number of updates = " FSTR64 "\n", NUPDATE);
+  fprintf( outFile, "Number of threads = %d\n", threads);
+  fprintf( outFile, "Generator         = %s\n", HPCC_RandomAccessGeneratorName( gen ));
+  }
+  params->RandomAccessUsedThreads = threads;
+
+  /* GUP/s for thread counts doubling up to the one used for the timed run */
+  if (params->RandomAccessThreadSweep) {
+    if (doIO) fprintf( outFile, "Threads  Update streams  GUP/s\n" );
+    for (t = 1; t < threads; t <<= 1) {
+      for (i=0; i<TableSize; i++) Table[i] = i;
+      sweepTime = -RTSEC();
+      RandomAccessUpdate( gen, logTableSize, TableSize, Table, t, params->RandomAccessAtomic );
+      sweepTime += RTSEC();
+      if (doIO) fprintf( outFile, "%7d %15d %.9f\n", t, RandomAccessStreams( t ),
+                         sweepTime > 0.0 ? 1e-9 * NUPDATE / sweepTime : -1.0 );
+    }
   }
 
   /* Initialize main table */
   for (i=0; i<TableSize; i++) Table[i] = i;
 
+  HPCC_RandomAccessTableReport( params, Table, doIO ? outFile : NULL );
+
   /* Begin timing here */
   cputime = -CPUSEC();
   realtime = -RTSEC();
 
-  RandomAccessUpdate( TableSize, Table );
+  RandomAccessUpdate( gen, logTableSize, TableSize, Table, threads, params->RandomAccessAtomic );
 
   /* End timed section */
   cputime += CPUSEC();
@@ -149,26 +231,60 @@ HPCC_RandomAccess(HPCC_Params *params, int doIO, double *GUPs, int *failure) {
   fprintf( outFile, "%.9f Billion(10^9) Updates    per second [GUP/s]\n", *GUPs );
   }
 
-  /* Verification of results (in serial or "safe" mode; optional) */
-  temp = 0x1;
-  for (i=0; i<NUPDATE; i++) {
-    temp = (temp << 1) ^ (((s64Int) temp < 0) ? POLY : 0);
-    Table[temp & (TableSize-1)] ^= temp;
+  /* Verification of results (in serial or "safe" mode; optional).  Every thread regenerates a
+     contiguous chunk of the update sequence starting from the jump-ahead to its first update;
+     the values are generated in batches (see HPCC_RandomAccessFill). */
+  realtime = -RTSEC();
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads)
+#endif
+  {
+    u64Int k, lo, hi, state, ran[LOCAL_BUFFER_SIZE];
+    int j, n, shift = HPCC_RA_SHIFT( gen, logTableSize ), me = 0, nt = 1;
+
+#ifdef _OPENMP
+    me = omp_get_thread_num();
+    nt = omp_get_num_threads();
+#endif
+
+    lo = NUPDATE / nt * me;
+    hi = me == nt - 1 ? NUPDATE : NUPDATE / nt * (me + 1);
+    state = HPCC_RandomAccessSeed( gen, (s64Int)lo );
+
+    for (k=lo; k<hi; k+=n) {
+      n = (int)Mmin( (u64Int)LOCAL_BUFFER_SIZE, hi - k );
+      HPCC_RandomAccessFill( gen, &state, ran, n );
+      if (nt > 1) {
+        for (j=0; j<n; j++) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+          Table[(ran[j] >> shift) & (TableSize-1)] ^= ran[j];
+        }
+      } else
+        HPCC_RandomAccessApply( Table, ran, n, shift, TableSize-1, 0 );
+    }
   }
 
   temp = 0;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads) reduction(+:temp)
+#endif
   for (i=0; i<TableSize; i++)
     if (Table[i] != i)
       temp++;
 
+  realtime += RTSEC();
+
   if (doIO) {
+  fprintf( outFile, "Verification:  Real time used = %.6f seconds\n", realtime);
   fprintf( outFile, "Found " FSTR64 " errors in " FSTR64 " locations (%s).\n",
            temp, TableSize, (temp <= 0.01*TableSize) ? "passed" : "failed");
   }
   if (temp <= 0.01*TableSize) *failure = 0;
   else *failure = 1;
 
-  HPCC_free( Table );
+  HPCC_RandomAccessTableFree( params, Table, TableSize );
 
   if (doIO) {
     fflush( outFile );
@@ -177,3 +293,14 @@ HPCC_RandomAccess(HPCC_Params *params, int doIO, double *GUPs, int *failure) {
 
   return 0;
 }
+
+int
+HPCC_RandomAccess(HPCC_Params *params, int doIO, double *GUPs, int *failure) {
+  return RandomAccessRun( params, HPCC_RandomAccessGenerator( params ), doIO, GUPs, failure,
+                          &params->RandomAccess_N );
+}
+
+int
+HPCC_RandomAccess_LCG(HPCC_Params *params, int doIO, double *GUPs, int *failure) {
+  return RandomAccessRun( params, HPCC_RA_LCG, doIO, GUPs, failure, &params->RandomAccess_LCG_N );
+}
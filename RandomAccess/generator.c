@@ -0,0 +1,173 @@
+/* -*- mode: C; tab-width: 2; indent-tabs-mode: nil; -*-
+ *
+ * This file provides the generators of the stream of updates of the
+ * RandomAccess benchmark suite (see generator.h).
+ */
+
+#include <hpcc.h>
+#include "RandomAccess.h"
+
+/* Spreads the low 32 bits of `x' to the even bits of the result */
+static u64Int
+Spread(u64Int x) {
+  x &= 0xFFFFFFFFULL;
+  x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x <<  8)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x <<  4)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x <<  2)) & 0x3333333333333333ULL;
+  x = (x | (x <<  1)) & 0x5555555555555555ULL;
+  return x;
+}
+
+/* Squares the polynomial `a' over GF(2) modulo x^64 + POLY.  A square has only the even powers,
+   so it is the bits of `a' spread out; the high word `hi' is reduced with
+   hi * x^64 = hi * (x^2 + x + 1) and the (at most 2) bits that this pushes past x^63 once more. */
+static u64Int
+Square(u64Int a) {
+  u64Int lo = Spread( a ), hi = Spread( a >> 32 ), o;
+
+  o = (hi >> 63) ^ (hi >> 62);
+  return lo ^ hi ^ (hi << 1) ^ (hi << 2) ^ o ^ (o << 1) ^ (o << 2);
+}
+
+/* Utility routine to start random number generator at Nth step: the result is x^n modulo the
+   generator polynomial, computed by squaring and multiplying by x for the bits of `n' */
+u64Int
+HPCC_starts(s64Int n)
+{
+  int i;
+  u64Int ran;
+
+  while (n < 0) n += PERIOD;
+  while (n > PERIOD) n -= PERIOD;
+  if (n == 0) return 0x1;
+
+  for (i=62; i>=0; i--)
+    if ((n >> i) & 1)
+      break;
+
+  ran = 0x2;
+  while (i > 0) {
+    ran = Square( ran );
+    i -= 1;
+    if ((n >> i) & 1)
+      ran = HPCC_RA_POLY_STEP( ran );
+  }
+
+  return ran;
+}
+
+/* Utility routine to start LCG random number generator at Nth step */
+u64Int
+HPCC_starts_LCG(s64Int n)
+{
+  u64Int mul_k, add_k, ran, un;
+
+  mul_k = LCG_MUL64;
+  add_k = LCG_ADD64;
+
+  ran = 1;
+  for (un = (u64Int)n; un; un >>= 1) {
+    if (un & 1)
+      ran = mul_k * ran + add_k;
+    add_k *= (mul_k + 1);
+    mul_k *= mul_k;
+  }
+
+  return ran;
+}
+
+/* Philox2x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11) with a
+   fixed key: ten rounds of a 32x32-bit multiplication whose halves are mixed with the other half
+   of the counter and the round key */
+#define PHILOX_M   0xD256D193ULL
+#define PHILOX_W   0x9E3779B9ULL
+#define PHILOX_KEY 0x243F6A88ULL
+#define PHILOX_ROUNDS 10
+
+static u64Int
+Philox(u64Int counter) {
+  u64Int lo = counter & 0xFFFFFFFFULL, hi = counter >> 32, key = PHILOX_KEY, p;
+  int r;
+
+  for (r = 0; r < PHILOX_ROUNDS; r++) {
+    p = PHILOX_M * lo;
+    lo = ((p >> 32) ^ key ^ hi) & 0xFFFFFFFFULL;
+    hi = p & 0xFFFFFFFFULL;
+    key = (key + PHILOX_W) & 0xFFFFFFFFULL;
+  }
+
+  return (hi << 32) | lo;
+}
+
+u64Int
+HPCC_Philox(u64Int counter) {
+  return Philox( counter );
+}
+
+/* Returns the state of generator `gen' after `n' values: the state from which the stream of
+   process p or thread t starts is found without generating the values before it */
+u64Int
+HPCC_RandomAccessSeed(int gen, s64Int n) {
+  if (HPCC_RA_PHILOX == gen) return (u64Int)n;
+  if (HPCC_RA_LCG == gen) return HPCC_starts_LCG( n );
+  return HPCC_starts( n );
+}
+
+/* Number of interleaved LCG sequences computed by HPCC_RandomAccessFill */
+#define FILL_LANES 8
+
+/* Stores the next `n' values of the stream in `values' and advances `state' past them.  The
+   Philox values are independent of each other and the LCG values FILL_LANES apart are related by
+   a single LCG step with the multiplier and increment of FILL_LANES steps, so both loops can be
+   vectorized; the POLY values have to be generated one after another. */
+void
+HPCC_RandomAccessFill(int gen, u64Int *state, u64Int *values, int n) {
+  u64Int s = *state, mul, add;
+  int i;
+
+  if (HPCC_RA_PHILOX == gen) {
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+    for (i = 0; i < n; i++)
+      values[i] = Philox( s + 1 + i );
+    *state = s + n;
+
+  } else if (HPCC_RA_LCG == gen) {
+    for (i = 0; i < n && i < FILL_LANES; i++)
+      values[i] = s = HPCC_RA_LCG_STEP( s );
+
+    if (n > FILL_LANES) {
+      for (mul = 1, add = 0, i = 0; i < FILL_LANES; i++) {
+        mul *= LCG_MUL64;
+        add = HPCC_RA_LCG_STEP( add );
+      }
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd safelen(FILL_LANES)
+#endif
+      for (i = FILL_LANES; i < n; i++)
+        values[i] = mul * values[i - FILL_LANES] + add;
+      s = values[n - 1];
+    }
+    *state = s;
+
+  } else {
+    for (i = 0; i < n; i++)
+      values[i] = s = HPCC_RA_POLY_STEP( s );
+    *state = s;
+  }
+}
+
+char *
+HPCC_RandomAccessGeneratorName(int gen) {
+  static char *names[3] = {"POLY", "LCG", "Philox"};
+  return gen >= 0 && gen < 3 ? names[gen] : "unknown";
+}
+
+/* Returns the generator selected by RA_Generator for the (non-LCG) RandomAccess benchmarks */
+int
+HPCC_RandomAccessGenerator(HPCC_Params *params) {
+  int gen = params->RandomAccessGenerator;
+  return HPCC_RA_LCG == gen || HPCC_RA_PHILOX == gen ? gen : HPCC_RA_POLY;
+}
@@ -0,0 +1,49 @@
+/* -*- mode: C; tab-width: 2; indent-tabs-mode: nil; -*- */
+
+/*
+ * Generators of the stream of updates of RandomAccess.  The state of a
+ * generator is a single 64-bit word:
+ *
+ *  POLY   - the shift-xor generator x^n modulo the primitive polynomial POLY;
+ *           the table index is taken from the low bits of the value
+ *  LCG    - the 64-bit linear congruential generator; the table index is taken
+ *           from the high bits of the value
+ *  PHILOX - the counter-based Philox2x32-10 generator; the state is the number
+ *           of values generated so every value can be computed independently
+ *           of the others (the table index is taken from the low bits)
+ */
+
+/* Random number generator */
+#ifdef LONG_IS_64BITS
+#define POLY 0x0000000000000007UL
+#define PERIOD 1317624576693539401L
+#else
+#define POLY 0x0000000000000007ULL
+#define PERIOD 1317624576693539401LL
+#endif
+
+#define LCG_MUL64 6364136223846793005ULL
+#define LCG_ADD64 1
+
+#define HPCC_RA_POLY   0
+#define HPCC_RA_LCG    1
+#define HPCC_RA_PHILOX 2
+
+#define HPCC_RA_POLY_STEP(s) (((s) << 1) ^ ((s64Int)(s) < 0 ? POLY : 0))
+#define HPCC_RA_LCG_STEP(s) (LCG_MUL64 * (s) + LCG_ADD64)
+
+/* Advances the state `s' of generator `gen' and evaluates to the next value of the stream */
+#define HPCC_RA_NEXT(gen, s) ((gen) == HPCC_RA_POLY ? ((s) = HPCC_RA_POLY_STEP( s )) : \
+  (gen) == HPCC_RA_LCG ? ((s) = HPCC_RA_LCG_STEP( s )) : HPCC_Philox( ++(s) ))
+
+/* The index of value `v' in a table of 2^`logTableSize' entries is (v >> shift) & (TableSize-1) */
+#define HPCC_RA_SHIFT(gen, logTableSize) ((gen) == HPCC_RA_LCG ? 64 - (int)(logTableSize) : 0)
+
+extern u64Int HPCC_starts (s64Int);
+extern u64Int HPCC_starts_LCG (s64Int);
+extern u64Int HPCC_Philox(u64Int counter);
+
+extern u64Int HPCC_RandomAccessSeed(int gen, s64Int n);
+extern void HPCC_RandomAccessFill(int gen, u64Int *state, u64Int *values, int n);
+extern char *HPCC_RandomAccessGeneratorName(int gen);
+extern int HPCC_RandomAccessGenerator(HPCC_Params *params);
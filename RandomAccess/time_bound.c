@@ -6,7 +6,7 @@
  * a specified time bound.
  *
  * The number of updates is estimated by performing
- * a fraction (currently 1% as defined in time_bound.h)
+ * a fraction (RA_SampleFraction, 1% by default)
  * of the default number of updates and
  * measuring the execution time. The maximum
  * number of updates then is estimated based on
@@ -20,15 +20,56 @@
 #include "time_bound.h"
 #include "buckets.h"
 
+/* Returns the number of updates per process that keeps the run within `timeBound' seconds and
+   sets `predicted' to the expected run time.  The time per update is measured by `sample' on a
+   fraction RA_SampleFraction of the default number of updates.  With RA_SampleRounds > 1 the
+   sampling is repeated until the standard error of the mean time per update falls below
+   RA_SampleTolerance of the mean or until RA_SampleRounds rounds were done; `rounds' is set to
+   the number of rounds.  All processes get the same result. */
+s64Int
+HPCC_RandomAccessTimeBound(HPCC_Params *params, HPCC_RandomAccess_tabparams_t tparams,
+  void (*sample)(HPCC_RandomAccess_tabparams_t, s64Int, double *), double timeBound,
+  double *predicted, int *rounds) {
+  s64Int SendCnt, ProcNumUpdates;
+  double iterTime, slowest, sum = 0.0, sumSq = 0.0, mean = 0.0, var;
+  int n, maxRounds = Mmax( 1, params->RandomAccessSampleRounds );
+
+  SendCnt = (s64Int)(Mmin( 1.0, params->RandomAccessSampleFraction ) * 4 * tparams.LocalTableSize);
+  SendCnt = Mmax( 1, SendCnt );
+
+  for (n = 1; n <= maxRounds; n++) {
+    sample( tparams, SendCnt, &iterTime );
+
+    /* be conservative: the slowest process determines the number of updates */
+    MPI_Allreduce( &iterTime, &slowest, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD );
+
+    sum += slowest;
+    sumSq += slowest * slowest;
+    mean = sum / n;
+
+    if (n > 1) {
+      var = Mmax( 0.0, (sumSq - n * mean * mean) / (n - 1) );
+      if (sqrt( var / n ) <= params->RandomAccessSampleTolerance * mean) break;
+    }
+  }
+  *rounds = Mmin( n, maxRounds );
+
+  ProcNumUpdates = 4 * tparams.LocalTableSize;
+  if (timeBound / mean < (double)ProcNumUpdates) ProcNumUpdates = (s64Int)(timeBound / mean);
+  *predicted = ProcNumUpdates * mean;
+
+  return ProcNumUpdates;
+}
+
 
-void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound, u64Int *EstimatedNumIter) {
+void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, s64Int SendCnt, double *IterTime) {
   s64Int i, j;
   int proc_count;
 
-  s64Int SendCnt;
-  u64Int Ran;
+  u64Int Ran, State;
   s64Int WhichPe;
-  u64Int LocalOffset;
+  u64Int GlobalOffset, LocalOffset;
+  int shift = HPCC_RA_SHIFT( tparams.Generator, tparams.logTableSize );
   int logLocalTableSize = tparams.logTableSize - tparams.logNumProcs;
   int NumberReceiving = tparams.NumProcs - 1;
 #ifdef USE_MULTIPLE_RECV
@@ -39,7 +80,6 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
   MPI_Request inreq, outreq = MPI_REQUEST_NULL;
 #endif
   int bufferBase;
-  u64Int inmsg;
   MPI_Status status;
   int have_done;
 
@@ -50,6 +90,7 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
   int peUpdates;
   int recvUpdates;
   Bucket_Ptr Buckets;
+  u64Int *sendBuffer;
 
   double ra_LoopRealTime;
   double iterTime;
@@ -66,6 +107,8 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
    *       Ran = (Ran << 1) ^ (((s64Int) Ran < 0) ? POLY : 0);
    *       Table[Ran & (TABSIZE-1)] ^= Ran;
    *     }
+   *
+   * for the POLY generator (see generator.h for the others).
    */
 
   ra_LoopRealTime = -RTSEC();
@@ -75,8 +118,7 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
   localBufferSize = LOCAL_BUFFER_SIZE;
   Buckets = HPCC_InitBuckets(tparams.NumProcs, maxPendingUpdates);
 
-  SendCnt = 4 * tparams.LocalTableSize/RA_SAMPLE_FACTOR;
-  Ran = HPCC_starts (4 * tparams.GlobalStartMyProc);
+  State = HPCC_RandomAccessSeed( tparams.Generator, 4 * tparams.GlobalStartMyProc );
 
   i = 0;
 #ifdef USE_MULTIPLE_RECV
@@ -107,10 +149,8 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
 #else
            bufferBase = 0;
 #endif
-           for (j=0; j < recvUpdates; j ++) {
-             inmsg = LocalRecvBuffer[bufferBase+j];
-             HPCC_Table[inmsg & (tparams.LocalTableSize - 1)] ^= inmsg;
-           }
+           HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                                   shift, tparams.LocalTableSize - 1, 0 );
          } else if (status.MPI_TAG == FINISHED_TAG) {
            /* we got a done message.  Thanks for playing... */
            NumberReceiving--;
@@ -130,10 +170,11 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
 
 
      if (pendingUpdates < maxPendingUpdates) {
-       Ran = (Ran << 1) ^ ((s64Int) Ran < ZERO64B ? POLY : ZERO64B);
-       WhichPe = (Ran >> logLocalTableSize) & (tparams.NumProcs - 1);
+       Ran = HPCC_RA_NEXT( tparams.Generator, State );
+       GlobalOffset = (Ran >> shift) & (tparams.TableSize-1);
+       WhichPe = GlobalOffset >> logLocalTableSize;
        if (WhichPe == tparams.MyProc) {
-         LocalOffset = (Ran & (tparams.TableSize - 1)) - tparams.GlobalStartMyProc;
+         LocalOffset = GlobalOffset - tparams.GlobalStartMyProc;
          HPCC_Table[LocalOffset] ^= Ran;
        }
        else {
@@ -147,8 +188,8 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
        MPI_Test(&outreq, &have_done, MPI_STATUS_IGNORE);
        if (have_done) {
          outreq = MPI_REQUEST_NULL;
-         pe = HPCC_GetUpdates (Buckets, LocalSendBuffer, localBufferSize, &peUpdates);
-         MPI_Isend(&LocalSendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
+         sendBuffer = HPCC_TakeUpdates(Buckets, &pe, &peUpdates);
+         MPI_Isend(sendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
                    MPI_COMM_WORLD, &outreq);
          pendingUpdates -= peUpdates;
        }
@@ -174,10 +215,8 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
 #else
            bufferBase = 0;
 #endif
-           for (j=0; j < recvUpdates; j ++) {
-             inmsg = LocalRecvBuffer[bufferBase+j];
-             HPCC_Table[inmsg & (tparams.LocalTableSize - 1)] ^= inmsg;
-           }
+           HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                                   shift, tparams.LocalTableSize - 1, 0 );
          } else if (status.MPI_TAG == FINISHED_TAG) {
            /* we got a done message.  Thanks for playing... */
            NumberReceiving--;
@@ -199,8 +238,8 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
      MPI_Test(&outreq, &have_done, MPI_STATUS_IGNORE);
      if (have_done) {
        outreq = MPI_REQUEST_NULL;
-       pe = HPCC_GetUpdates(Buckets, LocalSendBuffer, localBufferSize, &peUpdates);
-       MPI_Isend(&LocalSendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
+       sendBuffer = HPCC_TakeUpdates(Buckets, &pe, &peUpdates);
+       MPI_Isend(sendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
                  MPI_COMM_WORLD, &outreq);
        pendingUpdates -= peUpdates;
      }
@@ -211,7 +250,7 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
    for (proc_count = 0 ; proc_count < tparams.NumProcs ; ++proc_count) {
      if (proc_count == tparams.MyProc) { tparams.finish_req[tparams.MyProc] = MPI_REQUEST_NULL; continue; }
      /* send garbage - who cares, no one will look at it */
-     MPI_Isend(&Ran, 0, tparams.dtype64, proc_count, FINISHED_TAG,
+     MPI_Isend(&State, 0, tparams.dtype64, proc_count, FINISHED_TAG,
                MPI_COMM_WORLD, tparams.finish_req + proc_count);
    }
 
@@ -230,10 +269,8 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
 #else
        bufferBase = 0;
 #endif
-       for (j=0; j <recvUpdates; j ++) {
-         inmsg = LocalRecvBuffer[bufferBase+j];
-         HPCC_Table[inmsg & (tparams.LocalTableSize - 1)] ^= inmsg;
-       }
+       HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                               shift, tparams.LocalTableSize - 1, 0 );
      } else if (status.MPI_TAG == FINISHED_TAG) {
        /* we got a done message.  Thanks for playing... */
        NumberReceiving--;
@@ -253,18 +290,16 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
    ra_LoopRealTime += RTSEC();
 
    /* estimate largest number of iterations that satisfy time bound */
-   iterTime = (double)(ra_LoopRealTime/SendCnt);
-   *EstimatedNumIter = timeBound/iterTime;
+   *IterTime = iterTime = (double)(ra_LoopRealTime/SendCnt);
 #ifdef DEBUG_TIME_BOUND
    fprintf (stdout, "MyProc: %4d SampledNumIter: %8d ", tparams.MyProc, SendCnt);
-   fprintf (stdout, "LoopRealTime: %.8f IterTime: %.8f EstimatedNumIter: %8d\n",
-       ra_LoopRealTime, iterTime, *EstimatedNumIter);
+   fprintf (stdout, "LoopRealTime: %.8f IterTime: %.8f\n",
+       ra_LoopRealTime, iterTime);
 #endif
 
    MPI_Waitall( tparams.NumProcs, tparams.finish_req, tparams.finish_statuses);
 
    /* Be nice and clean up after ourselves */
-   HPCC_FreeBuckets(Buckets, tparams.NumProcs);
 #ifdef USE_MULTIPLE_RECV
   for (j = 0; j < NumRecvs; j++) {
     MPI_Cancel(&inreq[j]);
@@ -275,20 +310,21 @@ void HPCC_Power2NodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBoun
   MPI_Wait(&inreq, MPI_STATUS_IGNORE);
 #endif
   MPI_Wait(&outreq, MPI_STATUS_IGNORE);
+   HPCC_FreeBuckets(Buckets, tparams.NumProcs);
 
 /* end multiprocessor code */
 }
 
 
 
-void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound, u64Int *EstimatedNumIter) {
+void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, s64Int SendCnt, double *IterTime) {
   s64Int i, j;
   int proc_count;
 
-  s64Int SendCnt;
-  u64Int Ran;
+  u64Int Ran, State;
   s64Int WhichPe;
   u64Int GlobalOffset, LocalOffset;
+  int shift = HPCC_RA_SHIFT( tparams.Generator, tparams.logTableSize );
   int NumberReceiving = tparams.NumProcs - 1;
 #ifdef USE_MULTIPLE_RECV
   int index, NumRecvs;
@@ -297,7 +333,6 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
 #else
   MPI_Request inreq, outreq = MPI_REQUEST_NULL;
 #endif
-  u64Int inmsg;
   int bufferBase;
   MPI_Status status;
   int have_done;
@@ -309,6 +344,7 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
   int peUpdates;
   int recvUpdates;
   Bucket_Ptr Buckets;
+  u64Int *sendBuffer;
 
   double ra_LoopRealTime;
   double iterTime;
@@ -325,6 +361,8 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
    *       Ran = (Ran << 1) ^ (((s64Int) Ran < 0) ? POLY : 0);
    *       Table[Ran & (TABSIZE-1)] ^= Ran;
    *     }
+   *
+   * for the POLY generator (see generator.h for the others).
    */
 
   ra_LoopRealTime = -RTSEC();
@@ -334,8 +372,7 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
   localBufferSize = LOCAL_BUFFER_SIZE;
   Buckets = HPCC_InitBuckets(tparams.NumProcs, maxPendingUpdates);
 
-  SendCnt = 4 * tparams.LocalTableSize/RA_SAMPLE_FACTOR;
-  Ran = HPCC_starts (4 * tparams.GlobalStartMyProc);
+  State = HPCC_RandomAccessSeed( tparams.Generator, 4 * tparams.GlobalStartMyProc );
 
   i = 0;
 #ifdef USE_MULTIPLE_RECV
@@ -366,11 +403,8 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
 #else
           bufferBase = 0;
 #endif
-          for (j=0; j < recvUpdates; j ++) {
-            inmsg = LocalRecvBuffer[bufferBase+j];
-            LocalOffset = (inmsg & (tparams.TableSize - 1)) - tparams.GlobalStartMyProc;
-            HPCC_Table[LocalOffset] ^= inmsg;
-          }
+          HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                                  shift, tparams.TableSize - 1, tparams.GlobalStartMyProc );
         } else if (status.MPI_TAG == FINISHED_TAG) {
           /* we got a done message.  Thanks for playing... */
           NumberReceiving--;
@@ -390,15 +424,15 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
 
 
     if (pendingUpdates < maxPendingUpdates) {
-      Ran = (Ran << 1) ^ ((s64Int) Ran < ZERO64B ? POLY : ZERO64B);
-      GlobalOffset = Ran & (tparams.TableSize-1);
+      Ran = HPCC_RA_NEXT( tparams.Generator, State );
+      GlobalOffset = (Ran >> shift) & (tparams.TableSize-1);
       if ( GlobalOffset < tparams.Top)
         WhichPe = ( GlobalOffset / (tparams.MinLocalTableSize + 1) );
       else
         WhichPe = ( (GlobalOffset - tparams.Remainder) / tparams.MinLocalTableSize );
 
       if (WhichPe == tparams.MyProc) {
-        LocalOffset = (Ran & (tparams.TableSize - 1)) - tparams.GlobalStartMyProc;
+        LocalOffset = GlobalOffset - tparams.GlobalStartMyProc;
         HPCC_Table[LocalOffset] ^= Ran;
       }
       else {
@@ -412,8 +446,8 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
       MPI_Test(&outreq, &have_done, MPI_STATUS_IGNORE);
       if (have_done) {
         outreq = MPI_REQUEST_NULL;
-        pe = HPCC_GetUpdates (Buckets, LocalSendBuffer, localBufferSize, &peUpdates);
-        MPI_Isend(&LocalSendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
+        sendBuffer = HPCC_TakeUpdates(Buckets, &pe, &peUpdates);
+        MPI_Isend(sendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
                   MPI_COMM_WORLD, &outreq);
         pendingUpdates -= peUpdates;
       }
@@ -440,11 +474,8 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
 #else
           bufferBase = 0;
 #endif
-          for (j=0; j < recvUpdates; j ++) {
-            inmsg = LocalRecvBuffer[bufferBase+j];
-            LocalOffset = (inmsg & (tparams.TableSize - 1)) - tparams.GlobalStartMyProc;
-            HPCC_Table[LocalOffset] ^= inmsg;
-          }
+          HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                                  shift, tparams.TableSize - 1, tparams.GlobalStartMyProc );
         } else if (status.MPI_TAG == FINISHED_TAG) {
           /* we got a done message.  Thanks for playing... */
           NumberReceiving--;
@@ -466,8 +497,8 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
     MPI_Test(&outreq, &have_done, MPI_STATUS_IGNORE);
     if (have_done) {
       outreq = MPI_REQUEST_NULL;
-      pe = HPCC_GetUpdates (Buckets, LocalSendBuffer, localBufferSize, &peUpdates);
-      MPI_Isend(&LocalSendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
+      sendBuffer = HPCC_TakeUpdates(Buckets, &pe, &peUpdates);
+      MPI_Isend(sendBuffer, peUpdates, tparams.dtype64, (int)pe, UPDATE_TAG,
                 MPI_COMM_WORLD, &outreq);
       pendingUpdates -= peUpdates;
     }
@@ -478,7 +509,7 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
   for (proc_count = 0 ; proc_count < tparams.NumProcs ; ++proc_count) {
     if (proc_count == tparams.MyProc) { tparams.finish_req[tparams.MyProc] = MPI_REQUEST_NULL; continue; }
     /* send garbage - who cares, no one will look at it */
-    MPI_Isend(&Ran, 0, tparams.dtype64, proc_count, FINISHED_TAG,
+    MPI_Isend(&State, 0, tparams.dtype64, proc_count, FINISHED_TAG,
               MPI_COMM_WORLD, tparams.finish_req + proc_count);
   }
 
@@ -496,11 +527,8 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
 #else
       bufferBase = 0;
 #endif
-      for (j=0; j <recvUpdates; j ++) {
-        inmsg = LocalRecvBuffer[bufferBase+j];
-        LocalOffset = (inmsg & (tparams.TableSize - 1)) - tparams.GlobalStartMyProc;
-        HPCC_Table[LocalOffset] ^= inmsg;
-      }
+      HPCC_RandomAccessApply( HPCC_Table, LocalRecvBuffer + bufferBase, recvUpdates,
+                              shift, tparams.TableSize - 1, tparams.GlobalStartMyProc );
     } else if (status.MPI_TAG == FINISHED_TAG) {
       /* we got a done message.  Thanks for playing... */
       NumberReceiving--;
@@ -518,19 +546,17 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
   }
 
   ra_LoopRealTime += RTSEC();
-  iterTime = (double) (ra_LoopRealTime/SendCnt);
-  *EstimatedNumIter = (int)(timeBound/iterTime);
+  *IterTime = iterTime = (double) (ra_LoopRealTime/SendCnt);
 
 #ifdef DEBUG_TIME_BOUND
   fprintf (stdout, "MyProc: %4d SampledNumIter: %8d ", tparams.MyProc, SendCnt);
-  fprintf (stdout, "LoopRealTime: %.8f IterTime: %.8f EstimatedNumIter: %8d\n",
-     ra_LoopRealTime, iterTime, *EstimatedNumIter);
+  fprintf (stdout, "LoopRealTime: %.8f IterTime: %.8f\n",
+     ra_LoopRealTime, iterTime);
 #endif
 
   MPI_Waitall( tparams.NumProcs, tparams.finish_req, tparams.finish_statuses);
 
   /* Be nice and clean up after ourselves */
-  HPCC_FreeBuckets(Buckets, tparams.NumProcs);
 #ifdef USE_MULTIPLE_RECV
   for (j = 0; j < NumRecvs; j++) {
     MPI_Cancel(&inreq[j]);
@@ -541,6 +567,7 @@ void HPCC_AnyNodesTime(HPCC_RandomAccess_tabparams_t tparams, double timeBound,
   MPI_Wait(&inreq, MPI_STATUS_IGNORE);
 #endif
   MPI_Wait(&outreq, MPI_STATUS_IGNORE);
+  HPCC_FreeBuckets(Buckets, tparams.NumProcs);
 
   /* end multiprocessor code */
 }
@@ -7,61 +7,85 @@
 #include "RandomAccess.h"
 
 
-/* Utility routine to start random number generator at Nth step */
-u64Int
-HPCC_starts(s64Int n)
-{
-  int i, j;
-  u64Int m2[64];
-  u64Int temp, ran;
-
-  while (n < 0) n += PERIOD;
-  while (n > PERIOD) n -= PERIOD;
-  if (n == 0) return 0x1;
-
-  temp = 0x1;
-  for (i=0; i<64; i++) {
-    m2[i] = temp;
-    temp = (temp << 1) ^ ((s64Int) temp < 0 ? POLY : 0);
-    temp = (temp << 1) ^ ((s64Int) temp < 0 ? POLY : 0);
-  }
+#ifdef __GNUC__
+#define HPCC_RA_PREFETCH(p) __builtin_prefetch( (p), 1, 0 )
+#else
+#define HPCC_RA_PREFETCH(p) ((void)0)
+#endif
+
+/* Applies `number' updates from `data' to `table': the update `datum' goes to the entry
+   ((datum >> shift) & mask) - offset.  The updates are done in batches of HPCC_RA_BATCH: the
+   indices of the next batch are computed and their table entries prefetched before the XORs
+   of the current batch so that many cache misses are in flight at the same time.  Batches are
+   much shorter than the 1024 updates the rules allow to look ahead. */
+void
+HPCC_RandomAccessApply(u64Int *table, u64Int *data, int number, int shift, u64Int mask,
+  u64Int offset) {
+  u64Int index[2][HPCC_RA_BATCH];
+  int i, j, n, next, cur = 0;
 
-  for (i=62; i>=0; i--)
-    if ((n >> i) & 1)
-      break;
-
-  ran = 0x2;
-  while (i > 0) {
-    temp = 0;
-    for (j=0; j<64; j++)
-      if ((ran >> j) & 1)
-        temp ^= m2[j];
-    ran = temp;
-    i -= 1;
-    if ((n >> i) & 1)
-      ran = (ran << 1) ^ ((s64Int) ran < 0 ? POLY : 0);
+  n = Mmin( HPCC_RA_BATCH, number );
+  for (j = 0; j < n; j++) {
+    index[0][j] = ((data[j] >> shift) & mask) - offset;
+    HPCC_RA_PREFETCH( table + index[0][j] );
   }
 
-  return ran;
+  for (i = 0; i < number; i += n, cur ^= 1) {
+    n = Mmin( HPCC_RA_BATCH, number - i );
+    next = Mmin( HPCC_RA_BATCH, number - i - n );
+
+    for (j = 0; j < next; j++) {
+      index[cur ^ 1][j] = ((data[i + n + j] >> shift) & mask) - offset;
+      HPCC_RA_PREFETCH( table + index[cur ^ 1][j] );
+    }
+
+    for (j = 0; j < n; j++)
+      table[index[cur][j]] ^= data[i + j];
+  }
 }
 
-/* Utility routine to start LCG random number generator at Nth step */
-u64Int
-HPCC_starts_LCG(s64Int n)
-{
-  u64Int mul_k, add_k, ran, un;
-
-  mul_k = LCG_MUL64;
-  add_k = LCG_ADD64;
-
-  ran = 1;
-  for (un = (u64Int)n; un; un >>= 1) {
-    if (un & 1)
-      ran = mul_k * ran + add_k;
-    add_k *= (mul_k + 1);
-    mul_k *= mul_k;
+/* Allocates a table of `size' words with the pages selected by RA_HugePages (see
+   HPCC_PagesAlloc) and, if RA_Interleave is set, interleaved over all NUMA nodes.  The memory
+   policy has to be set before the table is first touched. */
+u64Int *
+HPCC_RandomAccessTableAlloc(HPCC_Params *params, u64Int size) {
+  u64Int *table;
+  int nodes;
+
+  table = HPCC_PagesAlloc( size * sizeof(u64Int), params->RandomAccessHugePages );
+  if (! table) return NULL;
+
+  params->RandomAccessInterleaveNodes = 0;
+  if (params->RandomAccessInterleave) {
+    nodes = HPCC_Interleave( table, size * sizeof(u64Int) );
+    if (nodes > 0) params->RandomAccessInterleaveNodes = nodes;
   }
 
-  return ran;
+  return table;
 }
 
+void
+HPCC_RandomAccessTableFree(HPCC_Params *params, u64Int *table, u64Int size) {
+  HPCC_PagesFree( table, size * sizeof(u64Int), params->RandomAccessHugePages );
+}
+
+/* Records the size of the pages backing the (initialized) table and prints the policy used */
+void
+HPCC_RandomAccessTableReport(HPCC_Params *params, u64Int *table, FILE *outFile) {
+  int thp;
+
+  params->RandomAccessPageSize = HPCC_PageSize( table, &thp );
+
+  if (outFile) {
+    if (params->RandomAccessPageSize < 0)
+      fprintf( outFile, "Table page size = unknown" );
+    else
+      fprintf( outFile, "Table page size = %ld KiB", params->RandomAccessPageSize / 1024 );
+    if (thp > 0) fprintf( outFile, " (%d%% transparent huge pages)", thp );
+    if (params->RandomAccessInterleaveNodes > 0)
+      fprintf( outFile, ", interleaved over %d NUMA nodes", params->RandomAccessInterleaveNodes );
+    else if (params->RandomAccessInterleave)
+      fprintf( outFile, ", NUMA interleaving not available" );
+    fprintf( outFile, "\n" );
+  }
+}
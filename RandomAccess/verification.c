@@ -8,9 +8,9 @@
 
 void
 HPCC_Power2NodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64Int *NumErrors) {
-  u64Int Ran, RanTmp;
+  u64Int Ran, RanTmp, State;
   s64Int NextSlot, WhichPe, PeBucketBase, SendCnt, errors, *PeCheckDone, il;
-  int i, j, n;
+  int i, j, n, shift = HPCC_RA_SHIFT( tparams.Generator, tparams.logTableSize );
   int LocalAllDone =  HPCC_FALSE;
   int sAbort, rAbort;
 
@@ -34,7 +34,7 @@ HPCC_Power2NodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64I
 
 
   SendCnt = tparams.ProcNumUpdates; /*  SendCnt = 4 * LocalTableSize; */
-  Ran = HPCC_starts (4 * tparams.GlobalStartMyProc);
+  State = HPCC_RandomAccessSeed( tparams.Generator, 4 * tparams.GlobalStartMyProc );
 
   PeCheckDone = XMALLOC ( s64Int, tparams.NumProcs);
 
@@ -53,8 +53,8 @@ HPCC_Power2NodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64I
       /* Fill local buckets until one is full or out of data */
       NextSlot = FIRST_SLOT;
       while(NextSlot != (BUCKET_SIZE+FIRST_SLOT) && SendCnt>0 ) {
-        Ran = (Ran << 1) ^ ((s64Int) Ran < ZERO64B ? POLY : ZERO64B);
-        WhichPe = (Ran >> (tparams.logTableSize - tparams.logNumProcs)) & (tparams.NumProcs - 1);
+        Ran = HPCC_RA_NEXT( tparams.Generator, State );
+        WhichPe = ((Ran >> shift) & (tparams.TableSize - 1)) >> (tparams.logTableSize - tparams.logNumProcs);
         PeBucketBase = WhichPe * (BUCKET_SIZE+FIRST_SLOT);
         NextSlot = LocalBuckets[PeBucketBase+SLOT_CNT];
         LocalBuckets[PeBucketBase+NextSlot] = Ran;
@@ -84,7 +84,7 @@ HPCC_Power2NodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64I
         n = (int)(GlobalBuckets[PeBucketBase+SLOT_CNT]);
         for (j = FIRST_SLOT; j < n; ++j) {
           RanTmp = GlobalBuckets[PeBucketBase+j];
-          HPCC_Table[RanTmp & (tparams.LocalTableSize-1)] ^= RanTmp;
+          HPCC_Table[(RanTmp >> shift) & (tparams.LocalTableSize-1)] ^= RanTmp;
         }
         LocalAllDone &= PeCheckDone[i];
       }
@@ -112,10 +112,10 @@ HPCC_Power2NodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64I
 
 void
 HPCC_AnyNodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64Int *NumErrors) {
-  u64Int Ran, RanTmp;
+  u64Int Ran, RanTmp, State;
   s64Int WhichPe, LocalOffset, NextSlot, PeBucketBase, SendCnt, errors, *PeCheckDone, il;
   u64Int GlobalOffset;
-  int i, j, n;
+  int i, j, n, shift = HPCC_RA_SHIFT( tparams.Generator, tparams.logTableSize );
   int LocalAllDone =  HPCC_FALSE;
   int sAbort, rAbort;
 
@@ -138,7 +138,7 @@ HPCC_AnyNodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64Int
 
 
   SendCnt = tparams.ProcNumUpdates; /* SendCnt = 4 * LocalTableSize; */
-  Ran = HPCC_starts (4 * tparams.GlobalStartMyProc);
+  State = HPCC_RandomAccessSeed( tparams.Generator, 4 * tparams.GlobalStartMyProc );
 
   PeCheckDone = XMALLOC (s64Int, tparams.NumProcs);
   for (i=0; i<tparams.NumProcs; i++)
@@ -156,8 +156,8 @@ HPCC_AnyNodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64Int
       /* Fill local buckets until one is full or out of data */
       NextSlot = FIRST_SLOT;
       while(NextSlot != (BUCKET_SIZE+FIRST_SLOT) && SendCnt>0 ) {
-        Ran = (Ran << 1) ^ ((s64Int) Ran < ZERO64B ? POLY : ZERO64B);
-        GlobalOffset = Ran & (tparams.TableSize-1);
+        Ran = HPCC_RA_NEXT( tparams.Generator, State );
+        GlobalOffset = (Ran >> shift) & (tparams.TableSize-1);
         if ( GlobalOffset < tparams.Top)
           WhichPe = ( GlobalOffset / (tparams.MinLocalTableSize + 1) );
         else
@@ -191,7 +191,7 @@ HPCC_AnyNodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64Int
         n = (int)(GlobalBuckets[PeBucketBase+SLOT_CNT]);
         for (j = FIRST_SLOT; j < n; ++j) {
           RanTmp = GlobalBuckets[PeBucketBase+j];
-          GlobalOffset = RanTmp & (tparams.TableSize - 1);
+          GlobalOffset = (RanTmp >> shift) & (tparams.TableSize - 1);
           LocalOffset = GlobalOffset - tparams.GlobalStartMyProc;
           HPCC_Table[LocalOffset] ^= RanTmp;
         }
@@ -220,3 +220,170 @@ HPCC_AnyNodesMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64Int
 
   return;
 }
+
+/* Largest number of updates generated by a process in one round of the bulk verification */
+#define BULK_MAX_CHUNK (1 << 24)
+
+/*
+  Bulk verification: every process generates its updates in chunks of `chunk' updates,
+  partitions each chunk by destination process with a counting sort, and exchanges the whole
+  chunk with a single MPI_Alltoallv.  Unlike the checkers above there is no barrier and no
+  fixed-size bucket per process and round, so the number of rounds is ProcNumUpdates/chunk
+  instead of at least ProcNumUpdates/1024.  It works for any number of processes and every
+  generator; the updates of a chunk are generated together (see HPCC_RandomAccessFill).
+ */
+void
+HPCC_BulkMPIRandomAccessCheck(HPCC_RandomAccess_tabparams_t tparams, s64Int chunk,
+  s64Int *NumErrors) {
+  u64Int State, GlobalOffset, *Updates, *SendBuf, *RecvBuf = NULL;
+  s64Int i, il, r, n, Rounds, MyRounds, errors;
+  int k, pe, shift, total, RecvCapacity = 0, sAbort, rAbort;
+  int *Dest, *SendCounts, *SendDispls, *RecvCounts, *RecvDispls, *Fill;
+
+  chunk = Mmax( 1, Mmin( chunk, BULK_MAX_CHUNK ) );
+  chunk = Mmin( chunk, Mmax( 1, tparams.ProcNumUpdates ) );
+
+  Updates = XMALLOC( u64Int, chunk );
+  SendBuf = XMALLOC( u64Int, chunk );
+  Dest = XMALLOC( int, chunk );
+  SendCounts = XMALLOC( int, 5 * tparams.NumProcs );
+
+  sAbort = 0; if (! Updates || ! SendBuf || ! Dest || ! SendCounts) sAbort = 1;
+  MPI_Allreduce( &sAbort, &rAbort, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD );
+  if (rAbort > 0) {
+    if (tparams.MyProc == 0) fprintf(stderr, "Failed to allocate memory for bulk verification.\n");
+    *NumErrors = tparams.LocalTableSize;
+    goto failed_bulk;
+  }
+
+  SendDispls = SendCounts + tparams.NumProcs;
+  RecvCounts = SendDispls + tparams.NumProcs;
+  RecvDispls = RecvCounts + tparams.NumProcs;
+  Fill = RecvDispls + tparams.NumProcs;
+
+  shift = HPCC_RA_SHIFT( tparams.Generator, tparams.logTableSize );
+  State = HPCC_RandomAccessSeed( tparams.Generator, 4 * tparams.GlobalStartMyProc );
+
+  /* all processes take part in every exchange until the last process is done */
+  MyRounds = (tparams.ProcNumUpdates + chunk - 1) / chunk;
+  MPI_Allreduce( &MyRounds, &Rounds, 1, tparams.dtype64, MPI_MAX, MPI_COMM_WORLD );
+
+  for (r = 0; r < Rounds; r++) {
+    n = Mmax( 0, Mmin( chunk, tparams.ProcNumUpdates - r * chunk ) );
+
+    for (k = 0; k < tparams.NumProcs; k++) SendCounts[k] = 0;
+
+    HPCC_RandomAccessFill( tparams.Generator, &State, Updates, (int)n );
+
+    for (i = 0; i < n; i++) {
+      GlobalOffset = (Updates[i] >> shift) & (tparams.TableSize - 1);
+      if (GlobalOffset < tparams.Top)
+        pe = (int)( GlobalOffset / (tparams.MinLocalTableSize + 1) );
+      else
+        pe = (int)( (GlobalOffset - tparams.Remainder) / tparams.MinLocalTableSize );
+      Dest[i] = pe;
+      SendCounts[pe]++;
+    }
+
+    for (SendDispls[0] = 0, k = 1; k < tparams.NumProcs; k++)
+      SendDispls[k] = SendDispls[k-1] + SendCounts[k-1];
+    for (k = 0; k < tparams.NumProcs; k++) Fill[k] = SendDispls[k];
+    for (i = 0; i < n; i++) SendBuf[Fill[Dest[i]]++] = Updates[i];
+
+    MPI_Alltoall( SendCounts, 1, MPI_INT, RecvCounts, 1, MPI_INT, MPI_COMM_WORLD );
+    for (RecvDispls[0] = 0, k = 1; k < tparams.NumProcs; k++)
+      RecvDispls[k] = RecvDispls[k-1] + RecvCounts[k-1];
+    total = RecvDispls[tparams.NumProcs-1] + RecvCounts[tparams.NumProcs-1];
+
+    if (total > RecvCapacity) {
+      if (RecvBuf) free( RecvBuf );
+      RecvCapacity = Mmax( total, RecvCapacity + RecvCapacity / 2 );
+      RecvBuf = XMALLOC( u64Int, RecvCapacity );
+      if (! RecvBuf) MPI_Abort( MPI_COMM_WORLD, -1 );
+    }
+
+    MPI_Alltoallv( SendBuf, SendCounts, SendDispls, tparams.dtype64,
+                   RecvBuf, RecvCounts, RecvDispls, tparams.dtype64, MPI_COMM_WORLD );
+
+    HPCC_RandomAccessApply( HPCC_Table, RecvBuf, total, shift, tparams.TableSize - 1,
+                            tparams.GlobalStartMyProc );
+  }
+
+  errors = 0;
+  for (il=0; il < tparams.LocalTableSize; il++)
+    if (HPCC_Table[il] != il + tparams.GlobalStartMyProc)
+      errors++;
+
+  *NumErrors = errors;
+
+  failed_bulk:
+
+  if (RecvBuf) free( RecvBuf );
+  if (SendCounts) free( SendCounts );
+  if (Dest) free( Dest );
+  if (SendBuf) free( SendBuf );
+  if (Updates) free( Updates );
+}
+
+static void
+StandardCheck(HPCC_RandomAccess_tabparams_t tparams, int PowerofTwo, s64Int *NumErrors) {
+  if (PowerofTwo)
+    HPCC_Power2NodesMPIRandomAccessCheck( tparams, NumErrors );
+  else
+    HPCC_AnyNodesMPIRandomAccessCheck( tparams, NumErrors );
+}
+
+/* Verifies the table with the checker selected by RA_BulkCheck and sets `NumErrors' to the local
+   number of errors.  With RA_BulkCheck=2 the bulk checker also runs on a copy of the table and
+   the number of entries in which the two results differ is reported on `outFile'. */
+void
+HPCC_MPIRandomAccessVerify(HPCC_Params *params, HPCC_RandomAccess_tabparams_t tparams,
+  int PowerofTwo, FILE *outFile, s64Int *NumErrors) {
+  s64Int il, BulkErrors;
+  u64Int *Standard, *Bulk;
+  double diff, GlbDiff;
+  int sAbort, rAbort;
+
+  if (1 == params->RandomAccessBulkCheck) {
+    HPCC_BulkMPIRandomAccessCheck( tparams, params->RandomAccessCheckChunk, NumErrors );
+    return;
+  }
+
+  if (2 != params->RandomAccessBulkCheck) {
+    StandardCheck( tparams, PowerofTwo, NumErrors );
+    return;
+  }
+
+  Standard = XMALLOC( u64Int, tparams.LocalTableSize );
+  sAbort = 0; if (! Standard) sAbort = 1;
+  MPI_Allreduce( &sAbort, &rAbort, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD );
+  if (rAbort > 0) {
+    if (outFile) fprintf( outFile, "Failed to allocate memory to validate the bulk verification.\n" );
+    if (Standard) free( Standard );
+    StandardCheck( tparams, PowerofTwo, NumErrors );
+    return;
+  }
+
+  memcpy( Standard, HPCC_Table, tparams.LocalTableSize * sizeof(u64Int) );
+
+  HPCC_BulkMPIRandomAccessCheck( tparams, params->RandomAccessCheckChunk, &BulkErrors );
+
+  /* the standard checker works on the global table */
+  Bulk = HPCC_Table;
+  HPCC_Table = Standard;
+  StandardCheck( tparams, PowerofTwo, NumErrors );
+  HPCC_Table = Bulk;
+
+  for (diff = 0.0, il = 0; il < tparams.LocalTableSize; il++)
+    if (HPCC_Table[il] != Standard[il]) diff += 1.0;
+
+  MPI_Reduce( &diff, &GlbDiff, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+
+  if (outFile) {
+    fprintf( outFile, "Bulk verification differs from the standard verification in %.0f entries (%s).\n",
+             GlbDiff, GlbDiff > 0.0 ? "failed" : "passed" );
+    if (GlbDiff > 0.0) params->Failure = 1;
+  }
+
+  free( Standard );
+}
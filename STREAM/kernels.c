@@ -0,0 +1,174 @@
+/* -*- mode: C; tab-width: 2; indent-tabs-mode: nil; fill-column: 79; coding: iso-latin-1-unix -*- */
+/*
+  Alternative implementations of the STREAM kernels.
+
+  Every variant provides the four kernels written as d = f(x, y) over n
+  elements. The SIMD variants are compiled with GCC's target attributes so
+  the rest of the code does not need to be compiled for a specific instruction
+  set; their availability is checked at runtime with cpuid. The "NT" variants
+  use non-temporal (streaming) stores that bypass the cache hierarchy.
+ */
+
+#include <hpcc.h>
+
+#include "stream.h"
+
+#if defined(__GNUC__) && defined(__x86_64__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define HPCC_STREAM_X86 1
+#include <immintrin.h>
+#endif
+
+static void
+ScalarCopy(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) {
+  size_t j;
+  (void)y; (void)s;
+  for (j = 0; j < n; j++) d[j] = x[j];
+}
+
+static void
+ScalarScale(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) {
+  size_t j;
+  (void)y;
+  for (j = 0; j < n; j++) d[j] = s*x[j];
+}
+
+static void
+ScalarAdd(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) {
+  size_t j;
+  (void)s;
+  for (j = 0; j < n; j++) d[j] = x[j]+y[j];
+}
+
+static void
+ScalarTriad(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) {
+  size_t j;
+  for (j = 0; j < n; j++) d[j] = x[j]+s*y[j];
+}
+
+#ifdef HPCC_STREAM_X86
+
+/* scalar non-temporal store of a double with MOVNTI */
+static void
+StoreNT(double *d, double v) {
+  long long i;
+  memcpy( &i, &v, sizeof i );
+  _mm_stream_si64( (long long *)d, i );
+}
+
+static void
+ScalarNTCopy(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) {
+  size_t j;
+  (void)y; (void)s;
+  for (j = 0; j < n; j++) StoreNT( d + j, x[j] );
+  _mm_sfence();
+}
+
+static void
+ScalarNTScale(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) {
+  size_t j;
+  (void)y;
+  for (j = 0; j < n; j++) StoreNT( d + j, s*x[j] );
+  _mm_sfence();
+}
+
+static void
+ScalarNTAdd(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) {
+  size_t j;
+  (void)s;
+  for (j = 0; j < n; j++) StoreNT( d + j, x[j]+y[j] );
+  _mm_sfence();
+}
+
+static void
+ScalarNTTriad(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) {
+  size_t j;
+  for (j = 0; j < n; j++) StoreNT( d + j, x[j]+s*y[j] );
+  _mm_sfence();
+}
+
+/*
+  Defines the four kernels for one vector width. Leading elements are done
+  one by one until `d' is aligned to the vector size (streaming stores
+  require it) and so are the trailing elements that do not fill a vector.
+ */
+#define HPCC_STREAM_SIMD(sfx, tgt, VT, W, LD, ST, SET1, ADD, MUL, FENCE) \
+static void __attribute__((target(tgt))) \
+sfx##Copy(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) { \
+  size_t j = 0; (void)y; (void)s; \
+  for (; j < n && (size_t)(d + j) % (W * sizeof(double)); j++) d[j] = x[j]; \
+  for (; j + W <= n; j += W) ST( d + j, LD( x + j ) ); \
+  for (; j < n; j++) d[j] = x[j]; \
+  FENCE; \
+} \
+static void __attribute__((target(tgt))) \
+sfx##Scale(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) { \
+  size_t j = 0; VT vs = SET1( s ); (void)y; \
+  for (; j < n && (size_t)(d + j) % (W * sizeof(double)); j++) d[j] = s*x[j]; \
+  for (; j + W <= n; j += W) ST( d + j, MUL( vs, LD( x + j ) ) ); \
+  for (; j < n; j++) d[j] = s*x[j]; \
+  FENCE; \
+} \
+static void __attribute__((target(tgt))) \
+sfx##Add(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) { \
+  size_t j = 0; (void)s; \
+  for (; j < n && (size_t)(d + j) % (W * sizeof(double)); j++) d[j] = x[j]+y[j]; \
+  for (; j + W <= n; j += W) ST( d + j, ADD( LD( x + j ), LD( y + j ) ) ); \
+  for (; j < n; j++) d[j] = x[j]+y[j]; \
+  FENCE; \
+} \
+static void __attribute__((target(tgt))) \
+sfx##Triad(double * restrict d, double * restrict x, double * restrict y, double s, size_t n) { \
+  size_t j = 0; VT vs = SET1( s ); \
+  for (; j < n && (size_t)(d + j) % (W * sizeof(double)); j++) d[j] = x[j]+s*y[j]; \
+  for (; j + W <= n; j += W) ST( d + j, ADD( LD( x + j ), MUL( vs, LD( y + j ) ) ) ); \
+  for (; j < n; j++) d[j] = x[j]+s*y[j]; \
+  FENCE; \
+}
+
+HPCC_STREAM_SIMD(AVX2, "avx2", __m256d, 4, _mm256_loadu_pd, _mm256_store_pd, _mm256_set1_pd,
+  _mm256_add_pd, _mm256_mul_pd, (void)0)
+HPCC_STREAM_SIMD(AVX2NT, "avx2", __m256d, 4, _mm256_loadu_pd, _mm256_stream_pd, _mm256_set1_pd,
+  _mm256_add_pd, _mm256_mul_pd, _mm_sfence())
+HPCC_STREAM_SIMD(AVX512, "avx512f", __m512d, 8, _mm512_loadu_pd, _mm512_store_pd, _mm512_set1_pd,
+  _mm512_add_pd, _mm512_mul_pd, (void)0)
+HPCC_STREAM_SIMD(AVX512NT, "avx512f", __m512d, 8, _mm512_loadu_pd, _mm512_stream_pd, _mm512_set1_pd,
+  _mm512_add_pd, _mm512_mul_pd, _mm_sfence())
+
+#define HPCC_STREAM_KERNELS(sfx) {sfx##Copy, sfx##Scale, sfx##Add, sfx##Triad}
+#else
+#define HPCC_STREAM_KERNELS(sfx) {NULL, NULL, NULL, NULL}
+#endif
+
+HPCC_StreamVariant HPCC_StreamVariants[HPCC_STREAM_VARIANTS] = {
+  {"Scalar", {ScalarCopy, ScalarScale, ScalarAdd, ScalarTriad}},
+  {"Scalar_NT", HPCC_STREAM_KERNELS(ScalarNT)},
+  {"AVX2", HPCC_STREAM_KERNELS(AVX2)},
+  {"AVX2_NT", HPCC_STREAM_KERNELS(AVX2NT)},
+  {"AVX512", HPCC_STREAM_KERNELS(AVX512)},
+  {"AVX512_NT", HPCC_STREAM_KERNELS(AVX512NT)}
+};
+
+char *
+HPCC_StreamVariantName(int v) {
+  return HPCC_StreamVariants[v].name;
+}
+
+char *
+HPCC_StreamKernelName(int k) {
+  static char *names[4] = {"Copy", "Scale", "Add", "Triad"};
+  return names[k];
+}
+
+/* Returns non-zero if the variant was compiled in and the CPU supports it */
+int
+HPCC_StreamVariantAvailable(int v) {
+  if (v < 0 || v >= HPCC_STREAM_VARIANTS || ! HPCC_StreamVariants[v].kernel[0]) return 0;
+
+#ifdef HPCC_STREAM_X86
+  __builtin_cpu_init();
+  if (v >= 4) return __builtin_cpu_supports( "avx512f" );
+  if (v >= 2) return __builtin_cpu_supports( "avx2" );
+#endif
+
+  return 1;
+}
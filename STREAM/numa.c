@@ -0,0 +1,195 @@
+/* -*- mode: C; tab-width: 2; indent-tabs-mode: nil; fill-column: 79; coding: iso-latin-1-unix -*- */
+/*
+  Thread binding and memory placement for the NUMA mode of STREAM.
+
+  If HPCC_USE_LIBNUMA is defined then libnuma is used to bind the vectors to
+  NUMA nodes and to check where their pages ended up (the binary needs to be
+  linked with -lnuma). Otherwise, the memory placement relies on the first
+  touch by a thread bound to a CPU and the NUMA node of the CPU (as reported
+  by sched_getcpu()) is taken from sysfs.
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE 1
+#include <sched.h>
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#include <hpcc.h>
+
+#include <ctype.h>
+
+#ifdef HPCC_USE_LIBNUMA
+#include <numa.h>
+#endif
+
+#include "stream.h"
+
+#ifdef __linux__
+#define HPCC_STREAM_MAXCPU CPU_SETSIZE
+#else
+#define HPCC_STREAM_MAXCPU 1
+#endif
+
+static int
+CmpInt(const void *a, const void *b) {
+  return *(const int *)a - *(const int *)b;
+}
+
+/* Lists CPUs available to the calling thread sorted by NUMA node; the caller frees the list */
+int
+HPCC_StreamCPUs(int **list) {
+  int *cpus;
+#ifdef __linux__
+  cpu_set_t mask;
+  int i, n;
+
+  *list = cpus = HPCC_XMALLOC( int, CPU_SETSIZE );
+  if (! cpus) return 0;
+
+  if (sched_getaffinity( 0, sizeof mask, &mask )) return 0;
+
+  for (n = i = 0; i < CPU_SETSIZE; i++)
+    if (CPU_ISSET( i, &mask ))
+      cpus[n++] = HPCC_StreamCPUNode( i ) * HPCC_STREAM_MAXCPU + i;
+
+  qsort( cpus, n, sizeof *cpus, CmpInt );
+
+  for (i = 0; i < n; i++)
+    cpus[i] %= HPCC_STREAM_MAXCPU;
+
+  return n;
+#else
+  *list = cpus = HPCC_XMALLOC( int, 1 );
+  return 0;
+#endif
+}
+
+size_t
+HPCC_StreamMaskSize(void) {
+#ifdef __linux__
+  return sizeof(cpu_set_t);
+#else
+  return 1;
+#endif
+}
+
+/* Binds the calling thread to `cpu' and stores its previous binding in `saved' */
+int
+HPCC_StreamBind(int cpu, void *saved) {
+#ifdef __linux__
+  cpu_set_t mask;
+
+  if (sched_getaffinity( 0, sizeof mask, (cpu_set_t *)saved )) return -1;
+
+  CPU_ZERO( &mask );
+  CPU_SET( cpu, &mask );
+
+  return sched_setaffinity( 0, sizeof mask, &mask );
+#else
+  return -1;
+#endif
+}
+
+void
+HPCC_StreamUnbind(void *saved) {
+#ifdef __linux__
+  sched_setaffinity( 0, sizeof(cpu_set_t), (cpu_set_t *)saved );
+#endif
+}
+
+int
+HPCC_StreamCurrentCPU(void) {
+#ifdef __linux__
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
+int
+HPCC_StreamCPUNode(int cpu) {
+#ifdef __linux__
+  char path[64];
+  DIR *d;
+  struct dirent *e;
+#endif
+  int node = 0;
+
+  if (cpu < 0) return 0;
+
+#ifdef HPCC_USE_LIBNUMA
+  if (numa_available() >= 0) return Mmax( numa_node_of_cpu( cpu ), 0 );
+#endif
+
+#ifdef __linux__
+  sprintf( path, "/sys/devices/system/cpu/cpu%d", cpu );
+  d = opendir( path );
+  if (d) {
+    while ((e = readdir( d )))
+      if (strncmp( e->d_name, "node", 4 ) == 0 && isdigit( e->d_name[4] )) {
+        node = atoi( e->d_name + 4 );
+        break;
+      }
+    closedir( d );
+  }
+#endif
+
+  return node;
+}
+
+/* Binds pages that are entirely within [ptr, ptr+size) to `node'; returns 0 on success */
+int
+HPCC_StreamToNode(void *ptr, size_t size, int node) {
+#ifdef HPCC_USE_LIBNUMA
+  size_t pg;
+  char *lo, *hi;
+
+  if (numa_available() < 0) return -1;
+
+  pg = numa_pagesize();
+  lo = (char *)(((size_t)ptr + pg - 1) / pg * pg);
+  hi = (char *)(((size_t)ptr + size) / pg * pg);
+
+  if (hi > lo) numa_tonode_memory( lo, hi - lo, node );
+
+  return 0;
+#else
+  (void)ptr; (void)size; (void)node;
+  return -1;
+#endif
+}
+
+/* Returns the fraction of sampled pages of [ptr, ptr+size) that are not on `node' or -1 if unknown */
+double
+HPCC_StreamMisplaced(void *ptr, size_t size, int node) {
+#ifdef HPCC_USE_LIBNUMA
+#define SAMPLES 256
+  void *pages[SAMPLES];
+  int status[SAMPLES];
+  int i, n, valid, bad;
+  size_t pg;
+
+  if (numa_available() < 0 || ! size) return -1.0;
+
+  pg = numa_pagesize();
+  n = Mmin( SAMPLES, size / pg + 1 );
+  for (i = 0; i < n; i++)
+    pages[i] = (char *)(((size_t)ptr + size / n * i) / pg * pg);
+
+  if (numa_move_pages( 0, n, pages, NULL, status, 0 )) return -1.0;
+
+  for (valid = bad = i = 0; i < n; i++)
+    if (status[i] >= 0) {
+      valid++;
+      if (status[i] != node) bad++;
+    }
+
+  return valid ? (double)bad / valid : -1.0;
+#undef SAMPLES
+#else
+  (void)ptr; (void)size; (void)node;
+  return -1.0;
+#endif
+}
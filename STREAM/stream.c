@@ -50,6 +50,8 @@
 #include <omp.h>
 #endif
 
+#include "stream.h"
+
 #define TUNED 1
 #define VERBOSE 1
 
@@ -106,7 +108,7 @@
  *         code using, for example, "-DNTIMES=7".
  */
 
-static int array_elements;
+static size_t array_elements;
 # define N 2000000
 # define NTIMES 10
 
@@ -124,6 +126,10 @@ static int array_elements;
 #define SCALAR 0.42
 #endif
 
+/* integer types use an integer scalar: the values grow by a factor of 15 per iteration so NTIMES
+   can be up to 14 for 64-bit integers */
+#define STREAM_SCALAR (stype->integer ? 3.0 : SCALAR)
+
 /*
 // ----------------------- !!! NOTE CHANGE IN DEFINITION !!! ------------------
 // The OFFSET preprocessor variable is not used in this version of the benchmark.
@@ -177,18 +183,50 @@ static int array_elements;
 /* Some compilers require an extra keyword to recognize the "restrict" qualifier. */
 static double * restrict a, * restrict b, * restrict c;
 
-static double avgtime[4] = {0}, maxtime[4] = {0},
-  mintime[4] = {FLT_MAX,FLT_MAX,FLT_MAX,FLT_MAX};
+/* Element type of the vectors: a, b, and c are declared as double for the tuned_STREAM_*()
+   functions but hold elements of type stype for other types. */
+static int type;
+static HPCC_StreamType *stype = HPCC_StreamTypes;
+
+/* the four STREAM kernels followed by the extra kernels: read-only sum, write-only fill,
+   strided Triad, and gather Triad */
+#define STREAM_KERNELS 8
+
+static double avgtime[STREAM_KERNELS] = {0}, maxtime[STREAM_KERNELS] = {0},
+  mintime[STREAM_KERNELS] = {FLT_MAX,FLT_MAX,FLT_MAX,FLT_MAX,FLT_MAX,FLT_MAX,FLT_MAX,FLT_MAX};
+
+static char *label[STREAM_KERNELS] = {"Copy:      ", "Scale:     ",
+    "Add:       ", "Triad:     ", "Sum:       ", "Fill:      ",
+    "Strided:   ", "Gather:    "};
+
+/* vector elements accessed per iteration */
+static double words[STREAM_KERNELS] = {2, 2, 3, 3, 1, 1, 3, 3};
 
-static char *label[4] = {"Copy:      ", "Scale:     ",
-    "Add:       ", "Triad:     "};
+/* bytes per iteration for the current element type; the strided Triad counts only the elements it
+   uses and the gather Triad also counts the index */
+static double bytes[STREAM_KERNELS];
 
-static double bytes[4] = {
-    2 * sizeof(double),
-    2 * sizeof(double),
-    3 * sizeof(double),
-    3 * sizeof(double)
-    };
+/* software prefetch kernels: distance in bytes ahead of the current element */
+static size_t prefetchDistance;
+
+/* extra kernels: stride of the strided Triad, indices of the gather Triad, and result of the sum */
+static int stride = 8;
+static size_t *idx;
+static double sum;
+
+/* NUMA mode: portions of the vectors owned by each thread (NULL otherwise) */
+static HPCC_StreamPart *part;
+static int partCount;
+
+/* kernels from HPCC_StreamVariants[] to use instead of the tuned_STREAM_*() functions (-1 if none) */
+static int variant = -1;
+
+/* Per-thread timing of the main loop: if `threadTimes' is not NULL, every thread of StreamRun()
+   stores the time it spent in the kernel at threadTimes[(kernel*NTIMES + threadIter)*threadMax + t]
+   along with the number of elements it processed and the CPU it ran on. */
+static double *threadTimes;
+static size_t *threadElements;
+static int *threadCPU, threadIter, threadMax, threadCount;
 
 #ifdef TUNED
 extern void tuned_STREAM_Copy(void);
@@ -199,54 +237,35 @@ extern void tuned_STREAM_Triad(double scalar);
 
 static void
 checkSTREAMresults(FILE *outFile, int doIO, double *AvgErrByRank, int numranks, int *failure) {
-  double aj,bj,cj,scalar;
+  double aj,bj,cj;
   double aSumErr,bSumErr,cSumErr;
   double aAvgErr,bAvgErr,cAvgErr;
-  double epsilon;
-  int j, k, ierr, err;
-
-  /* Repeat the computation of aj, bj, cj */
-  /* reproduce initialization */
-  aj = 1.0;
-  bj = 2.0;
-  cj = 0.0;
-  /* a[] is modified during timing check */
-  aj = 2.0E0 * aj;
-  /* now execute timing loop */
-  scalar = SCALAR;
-  for (k=0; k<NTIMES; k++) {
-    cj = aj;
-    bj = scalar*cj;
-    cj = aj+bj;
-    aj = bj+scalar*cj;
-  }
+  double epsilon, expected[3], sumErr, sumEpsilon;
+  size_t j, ierr;
+  int k, err;
+
+  /* Repeat the computation of aj, bj, cj in the element type */
+  stype->expected( STREAM_SCALAR, NTIMES, expected );
+  aj = expected[0];
+  bj = expected[1];
+  cj = expected[2];
 
   /* Compute the average of the average errors contributed by each MPI rank */
   aSumErr = 0.0;
   bSumErr = 0.0;
   cSumErr = 0.0;
+  sumErr = 0.0;
   for (k=0; k<numranks; k++) {
-          aSumErr += AvgErrByRank[3*k + 0];
-          bSumErr += AvgErrByRank[3*k + 1];
-          cSumErr += AvgErrByRank[3*k + 2];
+          aSumErr += AvgErrByRank[4*k + 0];
+          bSumErr += AvgErrByRank[4*k + 1];
+          cSumErr += AvgErrByRank[4*k + 2];
+          sumErr = Mmax( sumErr, AvgErrByRank[4*k + 3] );
   }
   aAvgErr = aSumErr / (double) numranks;
   bAvgErr = bSumErr / (double) numranks;
   cAvgErr = cSumErr / (double) numranks;
 
-  if (sizeof(double) == 4) {
-          epsilon = 1.e-6;
-  }
-  else if (sizeof(double) == 8) {
-          epsilon = 1.e-13;
-  }
-  else if (sizeof(double) == 10) {
-          epsilon = 1.e-23;
-  }
-  else {
-          if (doIO) fprintf( outFile, "WEIRD: sizeof(double) = %lu\n",sizeof(double));
-          epsilon = 1.e-6;
-  }
+  epsilon = stype->epsilon;
 
   *failure = 1;
 
@@ -260,13 +279,13 @@ checkSTREAMresults(FILE *outFile, int doIO, double *AvgErrByRank, int numranks,
     }
     ierr = 0;
     for (j=0; j<array_elements; j++) {
-      if (fabs(a[j]/aj-1.0) > epsilon) {
+      if (fabs(stype->get( a, j )/aj-1.0) > epsilon) {
         ierr++;
       }
     }
     if (ierr > 0)
       if (doIO)
-        fprintf( outFile, "     For array a[], %d errors were found.\n",ierr);
+        fprintf( outFile, "     For array a[], " FSTR64 " errors were found.\n", (s64Int)ierr);
   }
   if (fabs(bAvgErr/bj) > epsilon) {
     err++;
@@ -277,13 +296,13 @@ checkSTREAMresults(FILE *outFile, int doIO, double *AvgErrByRank, int numranks,
     }
     ierr = 0;
     for (j=0; j<array_elements; j++) {
-      if (fabs(b[j]/bj-1.0) > epsilon) {
+      if (fabs(stype->get( b, j )/bj-1.0) > epsilon) {
         ierr++;
       }
     }
     if (ierr > 0)
       if (doIO)
-        fprintf( outFile, "     For array b[], %d errors were found.\n",ierr);
+        fprintf( outFile, "     For array b[], " FSTR64 " errors were found.\n", (s64Int)ierr);
   }
   if (fabs(cAvgErr/cj) > epsilon) {
     err++;
@@ -294,18 +313,32 @@ checkSTREAMresults(FILE *outFile, int doIO, double *AvgErrByRank, int numranks,
     }
     ierr = 0;
     for (j=0; j<array_elements; j++) {
-      if (fabs(c[j]/cj-1.0) > epsilon) {
+      if (fabs(stype->get( c, j )/cj-1.0) > epsilon) {
         ierr++;
       }
     }
     if (ierr > 0)
       if (doIO)
-        fprintf( outFile, "     For array c[], %d errors were found.\n",ierr);
+        fprintf( outFile, "     For array c[], " FSTR64 " errors were found.\n", (s64Int)ierr);
+  }
+  /* the sum is accumulated in double, so allow for its rounding on top of that of the element type */
+  sumEpsilon = Mmax( epsilon, array_elements * DBL_EPSILON );
+  if (sumErr > sumEpsilon) {
+    err++;
+    if (doIO) {
+      fprintf( outFile, "Failed Validation of the Sum kernel, RelErr > epsilon (%e)\n",sumEpsilon);
+      fprintf( outFile, "     Expected Value: %e, Max RelErr of any rank: %e\n",
+               aj*array_elements*NTIMES,sumErr);
+    }
   }
   if (err == 0) {
     *failure = 0;
-    if (doIO)
-      fprintf( outFile, "Solution Validates: avg error less than %e on all three arrays\n",epsilon);
+    if (doIO) {
+      if (epsilon > 0.0)
+        fprintf( outFile, "Solution Validates: avg error less than %e on all three arrays\n",epsilon);
+      else
+        fprintf( outFile, "Solution Validates: no errors on all three arrays\n");
+    }
   }
 }
 
@@ -342,58 +375,892 @@ checktick() {
 #undef M
 
 
+#ifdef _OPENMP
+#define STREAM_WTIME omp_get_wtime
+#else
+#define STREAM_WTIME MPI_Wtime
+#endif
+
+#ifdef __GNUC__
+#define STREAM_PREFETCH(p, rw) __builtin_prefetch( (p), (rw), 0 )
+#else
+#define STREAM_PREFETCH(p, rw) ((void)0)
+#endif
+
+/* elements per cache line: the prefetch kernels issue one prefetch per vector and cache line */
+#define STREAM_LINE 8
+
+/* Double precision STREAM kernels that prefetch `prefetchDistance' bytes ahead of the current
+   element; the last elements, for which the prefetched addresses would be past the end, are
+   done without prefetching. */
+static void
+StreamPrefetchRange(int kernel, double scalar, size_t lo, size_t hi) {
+  size_t j, k, d = prefetchDistance / sizeof(double), end = hi > d + STREAM_LINE ? hi - d - STREAM_LINE : lo;
+  double *dst, *x, *y;
+
+  switch (kernel) {
+    case 0: dst = c; x = a; y = NULL; break;
+    case 1: dst = b; x = c; y = NULL; break;
+    case 2: dst = c; x = a; y = b; break;
+    default: dst = a; x = b; y = c; break;
+  }
+
+  for (j = lo; j < end; j += STREAM_LINE) {
+    STREAM_PREFETCH( x + j + d, 0 );
+    if (y) STREAM_PREFETCH( y + j + d, 0 );
+    STREAM_PREFETCH( dst + j + d, 1 );
+    switch (kernel) {
+      case 0: for (k = j; k < j + STREAM_LINE; k++) dst[k] = x[k]; break;
+      case 1: for (k = j; k < j + STREAM_LINE; k++) dst[k] = scalar*x[k]; break;
+      case 2: for (k = j; k < j + STREAM_LINE; k++) dst[k] = x[k]+y[k]; break;
+      case 3: for (k = j; k < j + STREAM_LINE; k++) dst[k] = x[k]+scalar*y[k]; break;
+    }
+  }
+
+  switch (kernel) {
+    case 0: for (; j < hi; j++) dst[j] = x[j]; break;
+    case 1: for (; j < hi; j++) dst[j] = scalar*x[j]; break;
+    case 2: for (; j < hi; j++) dst[j] = x[j]+y[j]; break;
+    case 3: for (; j < hi; j++) dst[j] = x[j]+scalar*y[j]; break;
+  }
+}
+
+/* Runs a kernel on elements [lo, hi); returns the partial result of the sum (0 for the other kernels).
+   For the fill, `scalar' is the value stored. See HPCC_StreamTypedKernel for the list of kernels;
+   10-13 are the double precision STREAM kernels with software prefetching. */
+static double
+StreamRange(int kernel, double scalar, size_t lo, size_t hi) {
+  HPCC_StreamKernel *k = HPCC_StreamVariants[variant < 0 ? 0 : variant].kernel;
+
+  if (kernel >= 10) {
+    StreamPrefetchRange( kernel - 10, scalar, lo, hi );
+    return 0.0;
+  }
+
+  if (type || kernel > 3)
+    return stype->range( kernel, a, b, c, idx, stride, scalar, lo, hi );
+
+  switch (kernel) {
+    case 0: k[0]( c + lo, a + lo, b + lo, scalar, hi - lo ); break;
+    case 1: k[1]( b + lo, c + lo, a + lo, scalar, hi - lo ); break;
+    case 2: k[2]( c + lo, a + lo, b + lo, scalar, hi - lo ); break;
+    case 3: k[3]( a + lo, b + lo, c + lo, scalar, hi - lo ); break;
+  }
+
+  return 0.0;
+}
+
+/* Runs a kernel `reps' times with each thread working on a contiguous portion of the first `n'
+   vector elements. In NUMA mode, only the portions that belong to NUMA node `node' are processed
+   (all of them if `node' is -1), every portion is processed by the thread that first touched it,
+   and if `n' is smaller than the vector size each portion is shortened proportionally. */
+static void
+StreamRun(int kernel, double scalar, int node, size_t n, int reps) {
+#ifdef _OPENMP
+#pragma omp parallel num_threads(part ? partCount : omp_get_max_threads())
+#endif
+  {
+    int t, nt, r;
+    size_t len, elements = 0;
+    double t0 = 0.0, s = 0.0;
+
+#ifdef _OPENMP
+    t = omp_get_thread_num();
+    nt = omp_get_num_threads();
+#else
+    t = 0;
+    nt = 1;
+#endif
+    if (threadTimes) t0 = STREAM_WTIME();
+
+    if (part) {
+      for (; t < partCount; t += nt)
+        if (-1 == node || part[t].node == node) {
+          len = part[t].hi - part[t].lo;
+          if (n != array_elements) len = (size_t)((double)len * n / array_elements);
+          elements += len;
+          for (r = 0; r < reps; r++)
+            s += StreamRange( kernel, scalar, part[t].lo, part[t].lo + len );
+        }
+    } else {
+      elements = n * (t + 1) / nt - n * t / nt;
+      for (r = 0; r < reps; r++)
+        s += StreamRange( kernel, scalar, n * t / nt, n * (t + 1) / nt );
+    }
+
+    if (4 == kernel) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+      sum += s;
+    }
+
+    if (threadTimes && kernel < 4) {
+#ifdef _OPENMP
+      t = omp_get_thread_num();
+#else
+      t = 0;
+#endif
+      if (t < threadMax) {
+        threadTimes[(kernel * NTIMES + threadIter) * threadMax + t] = STREAM_WTIME() - t0;
+        threadElements[t] = elements;
+        threadCPU[t] = HPCC_StreamCurrentCPU();
+      }
+      if (0 == t) threadCount = Mmin( nt, threadMax );
+    }
+  }
+}
+
+/* Binds threads to CPUs, splits the vectors between threads so that each NUMA node owns a contiguous
+   portion, places the portions on their nodes, and initializes them with the owning threads. */
+static int
+StreamNUMAInit(size_t n, char **saved) {
+  int *cpus, *order, ncpus, nthreads, i, k, t;
+  size_t lo, hi = 0;
+  size_t maskSize = HPCC_StreamMaskSize();
+
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#else
+  nthreads = 1;
+#endif
+
+  part = HPCC_XMALLOC( HPCC_StreamPart, nthreads );
+  order = HPCC_XMALLOC( int, nthreads );
+  *saved = HPCC_XMALLOC( char, nthreads * maskSize );
+  ncpus = HPCC_StreamCPUs( &cpus );
+
+  if (! part || ! order || ! *saved || ! cpus) {
+    if (cpus) HPCC_free( cpus );
+    if (*saved) HPCC_free( *saved );
+    if (order) HPCC_free( order );
+    if (part) HPCC_free( part );
+    part = NULL;
+    return 1;
+  }
+
+  partCount = nthreads;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nthreads) private(t)
+#endif
+  {
+#ifdef _OPENMP
+    t = omp_get_thread_num();
+#pragma omp single
+    partCount = omp_get_num_threads();
+#else
+    t = 0;
+#endif
+    if (ncpus > 0) HPCC_StreamBind( cpus[(long)t * ncpus / nthreads], *saved + t * maskSize );
+    part[t].cpu = HPCC_StreamCurrentCPU();
+    part[t].node = HPCC_StreamCPUNode( part[t].cpu );
+  }
+
+  /* order threads by NUMA node and hand out contiguous portions in that order */
+  for (t = 0; t < partCount; t++)
+    order[t] = t;
+  for (t = 1; t < partCount && t < nthreads; t++)
+    for (i = t; i > 0 && part[order[i-1]].node > part[order[i]].node; i--) {
+      k = order[i]; order[i] = order[i-1]; order[i-1] = k;
+    }
+  for (k = 0; k < partCount; k++) {
+    part[order[k]].lo = n * k / partCount;
+    part[order[k]].hi = n * (k + 1) / partCount;
+  }
+
+  for (k = 0; k < partCount; k = i) {
+    lo = part[order[k]].lo;
+    for (i = k; i < partCount && part[order[i]].node == part[order[k]].node; i++)
+      hi = part[order[i]].hi;
+    HPCC_StreamToNode( (char *)a + lo * stype->size, (hi - lo) * stype->size, part[order[k]].node );
+    HPCC_StreamToNode( (char *)b + lo * stype->size, (hi - lo) * stype->size, part[order[k]].node );
+    HPCC_StreamToNode( (char *)c + lo * stype->size, (hi - lo) * stype->size, part[order[k]].node );
+  }
+
+  /* first touch */
+#ifdef _OPENMP
+#pragma omp parallel num_threads(partCount) private(t)
+#endif
+  {
+#ifdef _OPENMP
+    for (t = omp_get_thread_num(); t < partCount; t += omp_get_num_threads())
+#else
+    for (t = 0; t < partCount; t++)
+#endif
+      StreamRange( 8, 0.0, part[t].lo, part[t].hi );
+  }
+
+  HPCC_free( order );
+  HPCC_free( cpus );
+
+  return 0;
+}
+
+static void
+StreamNUMAFinalize(char *saved) {
+#ifdef _OPENMP
+  size_t maskSize = HPCC_StreamMaskSize();
+
+#pragma omp parallel num_threads(partCount)
+  if (omp_get_thread_num() < partCount)
+    HPCC_StreamUnbind( saved + omp_get_thread_num() * maskSize );
+#else
+  HPCC_StreamUnbind( saved );
+#endif
+
+  HPCC_free( saved );
+  HPCC_free( part );
+  part = NULL;
+}
+
+/* Measures each NUMA node in isolation: only the threads of the node run the kernels on the node's
+   portion of the vectors while the remaining threads stay idle. */
+static void
+StreamNUMASockets(HPCC_Params *params, FILE *outFile, int doIO, MPI_Comm comm, double *allGBs) {
+  int i, j, k, t, node, nodeCount, maxNodeCount, threads, *nodes;
+  size_t elements;
+  double scalar = STREAM_SCALAR, times[4][NTIMES], nodeGBs[4], misplaced, m;
+  double triadMin = FLT_MAX, triadMax = -1.0;
+
+  nodes = HPCC_XMALLOC( int, partCount );
+  for (nodeCount = i = 0; i < partCount; i++) {
+    for (t = 0; t < nodeCount && nodes[t] != part[i].node; t++)
+      ; /* EMPTY */
+    if (t == nodeCount) nodes[nodeCount++] = part[i].node;
+  }
+
+  /* all ranks go through the same number of (possibly empty) tests to match the barriers */
+  MPI_Allreduce( &nodeCount, &maxNodeCount, 1, MPI_INT, MPI_MAX, comm );
+
+  if (doIO)
+    fprintf( outFile, "NUMA node  Threads   Elements  Misplaced  Copy (GB/s) Scale (GB/s)   Add (GB/s) Triad (GB/s)\n" );
+
+  for (i = 0; i < maxNodeCount; i++) {
+    node = i < nodeCount ? nodes[i] : -2;
+
+    threads = elements = 0;
+    misplaced = 0.0;
+    for (t = 0; t < partCount; t++)
+      if (part[t].node == node) {
+        threads++;
+        elements += part[t].hi - part[t].lo;
+        m = HPCC_StreamMisplaced( (char *)a + part[t].lo * stype->size, (part[t].hi - part[t].lo) * stype->size,
+                                  node );
+        misplaced = (m < 0.0 || misplaced < 0.0) ? -1.0 : misplaced + m * (part[t].hi - part[t].lo);
+      }
+    if (misplaced > 0.0) misplaced /= elements;
+
+    for (k=0; k<NTIMES; k++)
+      for (j=0; j<4; j++) {
+        MPI_Barrier( comm );
+        times[j][k] = MPI_Wtime();
+        StreamRun( j, scalar, node, array_elements, 1 );
+        MPI_Barrier( comm );
+        times[j][k] = MPI_Wtime() - times[j][k];
+      }
+
+    if (i >= nodeCount) continue;
+
+    for (j=0; j<4; j++) {
+      nodeGBs[j] = FLT_MAX;
+      for (k=1; k<NTIMES; k++) /* note -- skip first iteration */
+        nodeGBs[j] = Mmin( nodeGBs[j], times[j][k] );
+      nodeGBs[j] = (nodeGBs[j] > 0.0 ? 1e-9 * bytes[j] * elements / nodeGBs[j] : -1.0);
+    }
+
+    triadMin = Mmin( triadMin, nodeGBs[3] );
+    triadMax = Mmax( triadMax, nodeGBs[3] );
+
+    if (doIO) {
+      if (misplaced < 0.0)
+        fprintf( outFile, "%9d %8d %10.0f %10s", node, threads, (double)elements, "unknown" );
+      else
+        fprintf( outFile, "%9d %8d %10.0f %9.2f%%", node, threads, (double)elements, 100.0 * misplaced );
+      fprintf( outFile, " %12.4f %12.4f %12.4f %12.4f\n", nodeGBs[0], nodeGBs[1], nodeGBs[2], nodeGBs[3] );
+    }
+  }
+
+  if (doIO)
+    fprintf( outFile, "%-9s %8d %10.0f %10s %12.4f %12.4f %12.4f %12.4f\n", "All", partCount,
+             (double)array_elements, "", allGBs[0], allGBs[1], allGBs[2], allGBs[3] );
+
+  params->StreamNUMANodes = maxNodeCount;
+  MPI_Allreduce( &triadMin, &params->StreamNUMASocketMinTriadGBs, 1, MPI_DOUBLE, MPI_MIN, comm );
+  MPI_Allreduce( &triadMax, &params->StreamNUMASocketMaxTriadGBs, 1, MPI_DOUBLE, MPI_MAX, comm );
+
+  HPCC_free( nodes );
+}
+
+/* Reports the rates of individual threads in the main tests: the threads of rank 0 are listed and
+   the statistics over all threads of all ranks show the slowest thread. Each thread's rate is based
+   on its own best time (excluding the first iteration) rather than the time between barriers. */
+static void
+StreamThreadReport(HPCC_Params *params, FILE *outFile, int doIO, MPI_Comm comm) {
+  int i, j, k, t, myrank, slowThread[4], slowThreadAll[4];
+  double tmin, GBs, sums[12], sumsAll[12], avg, dev;
+  struct {double v; int r;} lo[4], hi[4], loAll[4], hiAll[4];
+
+  MPI_Comm_rank( comm, &myrank );
+
+  for (j = 0; j < 4; j++) {
+    sums[3*j] = sums[3*j+1] = sums[3*j+2] = 0.0;
+    lo[j].v = FLT_MAX;
+    hi[j].v = -1.0;
+    lo[j].r = hi[j].r = myrank;
+    slowThread[j] = 0;
+  }
+
+  if (doIO)
+    fprintf( outFile, "Thread   CPU     Elements  Copy (GB/s) Scale (GB/s)   Add (GB/s) Triad (GB/s)\n" );
+
+  for (t = 0; threadTimes && t < threadCount; t++) {
+    if (doIO)
+      fprintf( outFile, "%6d %5d %12.0f", t, threadCPU[t], (double)threadElements[t] );
+
+    for (j = 0; j < 4; j++) {
+      tmin = FLT_MAX;
+      for (k = 1; k < NTIMES; k++) /* note -- skip first iteration */
+        tmin = Mmin( tmin, threadTimes[(j * NTIMES + k) * threadMax + t] );
+      GBs = tmin > 0.0 ? 1e-9 * bytes[j] * threadElements[t] / tmin : 0.0;
+
+      if (doIO) fprintf( outFile, " %12.4f", GBs );
+
+      sums[3*j] += 1.0;
+      sums[3*j+1] += GBs;
+      sums[3*j+2] += GBs * GBs;
+      if (GBs < lo[j].v) {
+        lo[j].v = GBs;
+        slowThread[j] = t;
+      }
+      hi[j].v = Mmax( hi[j].v, GBs );
+    }
+
+    if (doIO) fprintf( outFile, "\n" );
+  }
+
+  MPI_Allreduce( sums, sumsAll, 12, MPI_DOUBLE, MPI_SUM, comm );
+  MPI_Allreduce( lo, loAll, 4, MPI_DOUBLE_INT, MPI_MINLOC, comm );
+  MPI_Allreduce( hi, hiAll, 4, MPI_DOUBLE_INT, MPI_MAXLOC, comm );
+
+  /* only the rank with the slowest thread contributes its thread number */
+  for (j = 0; j < 4; j++)
+    if (loAll[j].r != myrank) slowThread[j] = 0;
+  MPI_Allreduce( slowThread, slowThreadAll, 4, MPI_INT, MPI_SUM, comm );
+
+  if (doIO) {
+    fprintf( outFile, "Per-thread rates over all ranks:\n" );
+    fprintf( outFile, "Function   Min (GB/s)   Avg (GB/s)   Max (GB/s)  Dev (GB/s) Imbalance  Slowest rank/thread\n" );
+  }
+
+  for (j = 0; j < 4; j++) {
+    i = 3*j;
+    if (sumsAll[i] < 1.0) continue;
+
+    avg = sumsAll[i+1] / sumsAll[i];
+    dev = sqrt( Mmax( sumsAll[i+2] / sumsAll[i] - avg * avg, 0.0 ) );
+
+    if (doIO)
+      fprintf( outFile, "%s%11.4f  %11.4f  %11.4f %11.4f %8.2f%%  %d/%d\n", label[j], loAll[j].v, avg,
+               hiAll[j].v, dev, hiAll[j].v > 0.0 ? 100.0 * (1.0 - loAll[j].v / hiAll[j].v) : 0.0,
+               loAll[j].r, slowThreadAll[j] );
+
+    if (3 == j) {
+      params->StreamThreadMinTriadGBs = loAll[j].v;
+      params->StreamThreadMaxTriadGBs = hiAll[j].v;
+      params->StreamThreadStdDevTriadGBs = dev;
+      params->StreamSlowestRank = loAll[j].r;
+      params->StreamSlowestThread = slowThreadAll[j];
+    }
+  }
+}
+
+/* Measures the aggregate bandwidth of each node (a group of ranks that share memory) with 1, 2, ...
+   ranks per node running the kernels at the same time while the other ranks stay idle. The bandwidth
+   of a node is based on the time of its slowest active rank. */
+static void
+StreamContention(HPCC_Params *params, FILE *outFile, int doIO, MPI_Comm comm) {
+  int i, j, k, p, first, myrank, nodeRank, nodeSize, maxNodeSize, active, bestRanks = 0;
+  double scalar = STREAM_SCALAR, t, tmax, tmin[4], GBs[4], nodeGBs, sums[4][3], sumsAll[4][3];
+  double best = -1.0;
+  struct {double v; int r;} lo, hi, loAll, hiAll;
+  MPI_Comm node;
+
+  MPI_Comm_rank( comm, &myrank );
+
+#if MPI_VERSION >= 3
+  MPI_Comm_split_type( comm, MPI_COMM_TYPE_SHARED, myrank, MPI_INFO_NULL, &node );
+#else
+  MPI_Comm_split( comm, myrank, 0, &node ); /* every rank is a node of its own */
+#endif
+  MPI_Comm_rank( node, &nodeRank );
+  MPI_Comm_size( node, &nodeSize );
+  MPI_Allreduce( &nodeSize, &maxNodeSize, 1, MPI_INT, MPI_MAX, comm );
+
+  first = params->StreamContention > 1 ? 0 : 3; /* all kernels or Triad only */
+
+  if (doIO) {
+    fprintf( outFile, "Node contention: aggregate node bandwidth by number of active ranks per node\n" );
+    fprintf( outFile, "Ranks/node" );
+    if (! first)
+      fprintf( outFile, "  Copy (GB/s) Scale (GB/s)   Add (GB/s)" );
+    fprintf( outFile, " Triad (GB/s)  Min (GB/s)  Max (GB/s)  Per rank (GB/s)\n" );
+  }
+
+  for (p = 1; p <= maxNodeSize; p++) {
+    active = nodeRank < p;
+
+    for (j = first; j < 4; j++) {
+      tmin[j] = FLT_MAX;
+      for (k = 0; k < NTIMES; k++) {
+        MPI_Barrier( comm );
+        t = MPI_Wtime();
+        if (active) StreamRun( j, scalar, -1, array_elements, 1 );
+        t = active ? MPI_Wtime() - t : 0.0;
+
+        /* the node is as fast as its slowest active rank */
+        MPI_Allreduce( &t, &tmax, 1, MPI_DOUBLE, MPI_MAX, node );
+        if (k > 0) tmin[j] = Mmin( tmin[j], tmax ); /* note -- skip first iteration */
+      }
+    }
+
+    /* the first rank of every node contributes the node's bandwidth */
+    for (j = first; j < 4; j++) {
+      nodeGBs = tmin[j] > 0.0 ? 1e-9 * bytes[j] * array_elements * Mmin( p, nodeSize ) / tmin[j] : 0.0;
+      GBs[j] = nodeGBs;
+      sums[j][0] = nodeRank ? 0.0 : 1.0;
+      sums[j][1] = nodeRank ? 0.0 : nodeGBs;
+      sums[j][2] = nodeRank ? 0.0 : nodeGBs / Mmin( p, nodeSize );
+    }
+    MPI_Allreduce( sums[first], sumsAll[first], 3 * (4 - first), MPI_DOUBLE, MPI_SUM, comm );
+
+    lo.v = nodeRank ? FLT_MAX : GBs[3];
+    hi.v = nodeRank ? -1.0 : GBs[3];
+    lo.r = hi.r = myrank;
+    MPI_Allreduce( &lo, &loAll, 1, MPI_DOUBLE_INT, MPI_MINLOC, comm );
+    MPI_Allreduce( &hi, &hiAll, 1, MPI_DOUBLE_INT, MPI_MAXLOC, comm );
+
+    for (j = first; j < 4; j++)
+      for (i = 1; i < 3; i++)
+        sumsAll[j][i] /= sumsAll[j][0];
+
+    if (sumsAll[3][1] > best) {
+      best = sumsAll[3][1];
+      bestRanks = p;
+    }
+
+    if (doIO) {
+      fprintf( outFile, "%10d", p );
+      if (! first)
+        fprintf( outFile, " %12.4f %12.4f %12.4f", sumsAll[0][1], sumsAll[1][1], sumsAll[2][1] );
+      fprintf( outFile, " %12.4f %11.4f %11.4f %16.4f\n", sumsAll[3][1], loAll.v, hiAll.v, sumsAll[3][2] );
+    }
+  }
+
+  params->StreamContentionRanks = maxNodeSize;
+  params->StreamContentionBestRanks = bestRanks;
+  params->StreamContentionMaxNodeTriadGBs = best;
+
+  MPI_Comm_free( &node );
+}
+
+/* Seconds of a monotonic clock (or of MPI_Wtime() if it is not available) */
+static double
+StreamMonotonic(void) {
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+  if (0 == clock_gettime( CLOCK_MONOTONIC, &ts )) return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#endif
+  return MPI_Wtime();
+}
+
+static void
+StreamSleep(double seconds) {
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+
+  if (seconds <= 0.0) return;
+  ts.tv_sec = (time_t)seconds;
+  ts.tv_nsec = (long)(1e9 * (seconds - ts.tv_sec));
+  nanosleep( &ts, NULL );
+#else
+  double t = MPI_Wtime();
+  while (MPI_Wtime() - t < seconds)
+    ; /* EMPTY */
+#endif
+}
+
+/* Runs Triad on a slice of the vectors every STREAM_ProbeInterval seconds, either for a number of
+   iterations or seconds, and writes the time series of each rank to its own file. The ranks do
+   not synchronize while probing so the probe can run alongside other jobs. The per-thread timing
+   is suspended so that the probe does not overwrite the Triad times of the main loop. */
+static void
+StreamProbe(HPCC_Params *params, FILE *outFile, int doIO, MPI_Comm comm, int world_rank) {
+  int samples = 0;
+  size_t n;
+  double scalar = STREAM_SCALAR, t0, t1, start, GBs, rates[3], ratesAll[3], samplesAll;
+  double *savedTimes = threadTimes;
+  char fname[sizeof params->outFname + 32];
+  FILE *f;
+
+  n = (size_t)(Mmin( Mmax( params->StreamProbeSlice, 0.0 ), 1.0 ) * array_elements);
+  n = Mmax( n, 1 );
+
+  sprintf( fname, "%s.probe.%d", params->outFname, world_rank );
+  f = fopen( fname, "w" );
+  if (f) {
+    fprintf( f, "# STREAM probe of rank %d: Triad on " FSTR64 " elements (%.0f bytes) every %g seconds\n",
+             world_rank, (s64Int)n, bytes[3] * n, params->StreamProbeInterval );
+    fprintf( f, "# time: CLOCK_MONOTONIC seconds; the Unix time at start was %ld\n", (long)time( NULL ) );
+    fprintf( f, "#           time  Triad (GB/s)\n" );
+  }
+
+  rates[0] = FLT_MAX;
+  rates[1] = 0.0;
+  rates[2] = -1.0;
+
+  threadTimes = NULL;
+  StreamRun( 3, scalar, -1, n, 1 ); /* warm up */
+
+  for (start = StreamMonotonic(); ; ) {
+    t0 = StreamMonotonic();
+    StreamRun( 3, scalar, -1, n, 1 );
+    t1 = StreamMonotonic();
+
+    GBs = t1 > t0 ? 1e-9 * bytes[3] * n / (t1 - t0) : 0.0;
+    rates[0] = Mmin( rates[0], GBs );
+    rates[1] += GBs;
+    rates[2] = Mmax( rates[2], GBs );
+    samples++;
+
+    if (f) fprintf( f, "%16.9f %13.4f\n", t1, GBs );
+
+    if (params->StreamProbeIterations > 0) {
+      if (samples >= params->StreamProbeIterations) break;
+    } else if (t1 - start >= params->StreamProbeSeconds)
+      break;
+
+    StreamSleep( params->StreamProbeInterval - (StreamMonotonic() - t0) );
+  }
+
+  if (f) fclose( f );
+  threadTimes = savedTimes;
+
+  rates[1] /= samples;
+  MPI_Allreduce( rates, ratesAll, 1, MPI_DOUBLE, MPI_MIN, comm );
+  MPI_Allreduce( rates + 1, ratesAll + 1, 1, MPI_DOUBLE, MPI_SUM, comm );
+  MPI_Allreduce( rates + 2, ratesAll + 2, 1, MPI_DOUBLE, MPI_MAX, comm );
+  GBs = samples;
+  MPI_Allreduce( &GBs, &samplesAll, 1, MPI_DOUBLE, MPI_SUM, comm );
+  MPI_Comm_size( comm, &samples );
+  ratesAll[1] /= samples;
+
+  params->StreamProbeSamples = (int)samplesAll;
+  params->StreamProbeMinTriadGBs = ratesAll[0];
+  params->StreamProbeAvgTriadGBs = ratesAll[1];
+  params->StreamProbeMaxTriadGBs = ratesAll[2];
+
+  if (doIO) {
+    fprintf( outFile, "Probe: %d samples of Triad on " FSTR64 " elements per rank written to %s.probe.*\n",
+             params->StreamProbeSamples, (s64Int)n, params->outFname );
+    fprintf( outFile, "Probe Triad (GB/s per rank): min %.4f avg %.4f max %.4f\n", ratesAll[0], ratesAll[1],
+             ratesAll[2] );
+  }
+}
+
+static size_t
+StreamGCD(size_t x, size_t y) {
+  size_t r;
+  for (; y; x = y, y = r)
+    r = x % y;
+  return x;
+}
+
+/* x*y mod n without overflow */
+static size_t
+StreamMulMod(size_t x, size_t y, size_t n) {
+  size_t r = 0;
+  for (x %= n; y; y >>= 1, x = x >= n - x ? x - (n - x) : x + x)
+    if (y & 1) r = r >= n - x ? r - (n - x) : r + x;
+  return r;
+}
+
+/* Sets up the indices of the gather Triad as the permutation i -> i*p mod n, where p is the number
+   closest to n times the golden ratio that is coprime with n. Consecutive elements of `b' are
+   gathered from far apart pages so neither caches nor hardware prefetchers help. */
+static void
+StreamGatherInit(void) {
+  size_t p, n = array_elements;
+
+  for (p = (size_t)(0.6180339887 * n) + 1; StreamGCD( p, n ) != 1; p++)
+    ; /* EMPTY */
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    int t, nt;
+    size_t j, lo, hi, v;
+
+#ifdef _OPENMP
+    t = omp_get_thread_num();
+    nt = omp_get_num_threads();
+#else
+    t = 0;
+    nt = 1;
+#endif
+    lo = n * t / nt;
+    hi = n * (t + 1) / nt;
+    for (v = StreamMulMod( lo, p, n ), j = lo; j < hi; j++) {
+      idx[j] = v;
+      v = v >= n - p ? v - (n - p) : v + p;
+    }
+  }
+}
+
+/* Selects kernels for the main tests: 0 stands for the tuned_STREAM_*() functions and other values
+   for entries of HPCC_StreamVariants[] (shifted by 1). If the CPU does not support the requested
+   instruction set, the next narrower one with the same kind of stores is used. */
+static int
+StreamSelect(int kernels, MPI_Comm comm) {
+  int v, vAll;
+
+  v = kernels - 1;
+  if (v >= HPCC_STREAM_VARIANTS) v = HPCC_STREAM_VARIANTS - 1;
+  for (; v >= 0 && ! HPCC_StreamVariantAvailable( v ); v -= 2)
+    ; /* EMPTY */
+  if (v < 0 && kernels > 0) v = 0;
+
+  /* all ranks use the same kernels */
+  MPI_Allreduce( &v, &vAll, 1, MPI_INT, MPI_MIN, comm );
+
+  return vAll;
+}
+
+/* Measures the STREAM kernels with software prefetching at distances from 64 bytes up to
+   STREAM_PrefetchMax bytes (doubled at every step) and without it (distance 0), and reports the
+   best distance for every kernel. */
+static void
+StreamPrefetch(HPCC_Params *params, FILE *outFile, int doIO, MPI_Comm comm) {
+  int j, k;
+  size_t dist;
+  double scalar = STREAM_SCALAR, times[4][NTIMES], times_copy[4][NTIMES], GBs[4];
+
+  if (type) {
+    if (doIO) fprintf( outFile, "Prefetch kernels are available only for double.\n" );
+    return;
+  }
+
+  for (j = 0; j < 4; j++)
+    params->StreamPrefetchGBs[j] = -1.0;
+
+  if (doIO)
+    fprintf( outFile, "Prefetch (bytes)  Copy (GB/s) Scale (GB/s)   Add (GB/s) Triad (GB/s)\n" );
+
+  for (dist = 0; dist <= (size_t)Mmax( params->StreamPrefetchMax, 0 ); dist = dist ? 2 * dist : 64) {
+    prefetchDistance = dist;
+
+    for (k=0; k<NTIMES; k++)
+      for (j=0; j<4; j++) {
+        MPI_Barrier( comm );
+        times[j][k] = MPI_Wtime();
+        StreamRun( 10 + j, scalar, -1, array_elements, 1 );
+        MPI_Barrier( comm );
+        times[j][k] = MPI_Wtime() - times[j][k];
+      }
+
+    memcpy( times_copy, times, sizeof times_copy );
+    MPI_Allreduce( times_copy, times, 4*NTIMES, MPI_DOUBLE, MPI_MIN, comm );
+
+    for (j=0; j<4; j++) {
+      GBs[j] = FLT_MAX;
+      for (k=1; k<NTIMES; k++) /* note -- skip first iteration */
+        GBs[j] = Mmin( GBs[j], times[j][k] );
+      GBs[j] = (GBs[j] > 0.0 ? 1e-9 * bytes[j] * array_elements / GBs[j] : -1.0);
+
+      if (GBs[j] > params->StreamPrefetchGBs[j]) {
+        params->StreamPrefetchGBs[j] = GBs[j];
+        params->StreamPrefetchDistance[j] = (int)dist;
+      }
+    }
+
+    if (doIO)
+      fprintf( outFile, "%16.0f %12.4f %12.4f %12.4f %12.4f\n", (double)dist, GBs[0], GBs[1], GBs[2], GBs[3] );
+  }
+
+  if (doIO) {
+    fprintf( outFile, "Best distance   " );
+    for (j=0; j<4; j++)
+      fprintf( outFile, " %12d", params->StreamPrefetchDistance[j] );
+    fprintf( outFile, "\n" );
+  }
+}
+
+/* Measures all the kernel variants supported by the CPU. */
+static void
+StreamVariants(HPCC_Params *params, FILE *outFile, int doIO, MPI_Comm comm) {
+  int v, j, k, avail, availAll, mainVariant = variant;
+  double scalar = STREAM_SCALAR, times[4][NTIMES], times_copy[4][NTIMES], GBs[4];
+
+  if (type) {
+    if (doIO) fprintf( outFile, "Kernel variants are available only for double.\n" );
+    return;
+  }
+
+  if (doIO)
+    fprintf( outFile, "Kernels     Copy (GB/s) Scale (GB/s)   Add (GB/s) Triad (GB/s)\n" );
+
+  for (v = 0; v < HPCC_STREAM_VARIANTS; v++) {
+    avail = HPCC_StreamVariantAvailable( v );
+    MPI_Allreduce( &avail, &availAll, 1, MPI_INT, MPI_MIN, comm );
+    if (! availAll) {
+      if (doIO) fprintf( outFile, "%-10s  not available\n", HPCC_StreamVariants[v].name );
+      continue;
+    }
+
+    variant = v;
+    for (k=0; k<NTIMES; k++)
+      for (j=0; j<4; j++) {
+        MPI_Barrier( comm );
+        times[j][k] = MPI_Wtime();
+        StreamRun( j, scalar, -1, array_elements, 1 );
+        MPI_Barrier( comm );
+        times[j][k] = MPI_Wtime() - times[j][k];
+      }
+
+    memcpy( times_copy, times, sizeof times_copy );
+    MPI_Allreduce( times_copy, times, 4*NTIMES, MPI_DOUBLE, MPI_MIN, comm );
+
+    for (j=0; j<4; j++) {
+      GBs[j] = FLT_MAX;
+      for (k=1; k<NTIMES; k++) /* note -- skip first iteration */
+        GBs[j] = Mmin( GBs[j], times[j][k] );
+      GBs[j] = (GBs[j] > 0.0 ? 1e-9 * bytes[j] * array_elements / GBs[j] : -1.0);
+    }
+
+    params->StreamVariantTriadGBs[v] = GBs[3];
+
+    if (doIO)
+      fprintf( outFile, "%-10s %12.4f %12.4f %12.4f %12.4f\n", HPCC_StreamVariants[v].name,
+               GBs[0], GBs[1], GBs[2], GBs[3] );
+  }
+
+  variant = mainVariant;
+}
+
+/* Measures the kernels on a geometric series of vector sizes, from caches to main memory. Small
+   sizes repeat the kernel inside the timed region so that each measurement takes at least
+   STREAM_SWEEP_TIME seconds. Rates are per rank: the average over the ranks and the rate of the
+   slowest rank are reported. */
+#define STREAM_SWEEP_TIME 1e-3
+static void
+StreamSweep(HPCC_Params *params, FILE *outFile, int doIO, MPI_Comm comm) {
+  int i, j, k, reps, repsAll, numranks, first, steps;
+  size_t n, prevN;
+  double scalar = STREAM_SCALAR, t, tmin, size, minSize, maxSize, GBs[4], GBsSum[4], triadMin;
+  double sweepMin = FLT_MAX, sweepMax = -1.0;
+
+  MPI_Comm_size( comm, &numranks );
+
+  first = params->StreamSweep > 1 ? 0 : 3; /* all kernels or Triad only */
+  steps = Mmax( params->StreamSweepSteps, 1 );
+  maxSize = 3.0 * stype->size * array_elements;
+  minSize = Mmin( Mmax( (double)params->StreamSweepMin, 3.0 * stype->size ), maxSize );
+
+  if (doIO) {
+    fprintf( outFile, "Working set sweep (per-rank rates averaged over ranks)\n" );
+    fprintf( outFile, "       Bytes     Reps" );
+    if (! first)
+      fprintf( outFile, "  Copy (GB/s) Scale (GB/s)   Add (GB/s)" );
+    fprintf( outFile, " Triad (GB/s) Slowest rank\n" );
+  }
+
+  params->StreamSweepPoints = 0;
+  for (prevN = 0, i = 0; prevN < array_elements; i++) {
+    size = minSize * pow( 2.0, (double)i / steps );
+    n = size < maxSize ? (size_t)(size / (3.0 * stype->size)) : array_elements;
+    if (n <= prevN) continue;
+    prevN = n;
+
+    for (j = first; j < 4; j++) {
+      /* warm up caches and calibrate the number of repetitions; all ranks use the same one */
+      StreamRun( j, scalar, -1, n, 1 );
+      t = MPI_Wtime();
+      StreamRun( j, scalar, -1, n, 1 );
+      t = MPI_Wtime() - t;
+      reps = t > 0.0 ? (int)Mmin( STREAM_SWEEP_TIME / t + 1.0, 1e6 ) : 1000;
+      MPI_Allreduce( &reps, &repsAll, 1, MPI_INT, MPI_MAX, comm );
+      reps = repsAll;
+
+      tmin = FLT_MAX;
+      for (k = 0; k < NTIMES; k++) {
+        MPI_Barrier( comm );
+        t = MPI_Wtime();
+        StreamRun( j, scalar, -1, n, reps );
+        t = MPI_Wtime() - t;
+        tmin = Mmin( tmin, t );
+      }
+
+      GBs[j] = tmin > 0.0 ? 1e-9 * bytes[j] * n * reps / tmin : -1.0;
+    }
+
+    MPI_Allreduce( GBs + first, GBsSum + first, 4 - first, MPI_DOUBLE, MPI_SUM, comm );
+    MPI_Allreduce( GBs + 3, &triadMin, 1, MPI_DOUBLE, MPI_MIN, comm );
+
+    for (j = first; j < 4; j++)
+      GBsSum[j] /= numranks;
+
+    sweepMin = Mmin( sweepMin, GBsSum[3] );
+    sweepMax = Mmax( sweepMax, GBsSum[3] );
+    params->StreamSweepPoints++;
+
+    if (doIO) {
+      fprintf( outFile, "%12.0f %8d", 3.0 * stype->size * n, reps );
+      if (! first)
+        fprintf( outFile, " %12.4f %12.4f %12.4f", GBsSum[0], GBsSum[1], GBsSum[2] );
+      fprintf( outFile, " %12.4f %12.4f\n", GBsSum[3], triadMin );
+    }
+  }
+
+  params->StreamSweepMinTriadGBs = sweepMin;
+  params->StreamSweepMaxTriadGBs = sweepMax;
+}
+#undef STREAM_SWEEP_TIME
+
 /*
 For the MPI code I separate the computation of errors from the error
 reporting output functions (which are handled by MPI rank 0).
 */
 void computeSTREAMerrors(double *aAvgErr, double *bAvgErr, double *cAvgErr)
 {
-  double aj,bj,cj,scalar;
-  double aSumErr,bSumErr,cSumErr;
-  int j;
-  int k;
-
-  /* reproduce initialization */
-  aj = 1.0;
-  bj = 2.0;
-  cj = 0.0;
-  /* a[] is modified during timing check */
-  aj = 2.0E0 * aj;
-  /* now execute timing loop */
-  scalar = SCALAR;
-  for (k=0; k<NTIMES; k++)
-  {
-      cj = aj;
-      bj = scalar*cj;
-      cj = aj+bj;
-      aj = bj+scalar*cj;
-  }
+  double expected[3], avgErr[3];
+
+  /* reproduce initialization and timing loop in the element type */
+  stype->expected( STREAM_SCALAR, NTIMES, expected );
 
   /* accumulate deltas between observed and expected results */
-  aSumErr = 0.0;
-  bSumErr = 0.0;
-  cSumErr = 0.0;
-  for (j=0; j<array_elements; j++) {
-    aSumErr += fabs(a[j] - aj);
-    bSumErr += fabs(b[j] - bj);
-    cSumErr += fabs(c[j] - cj);
-  }
-  *aAvgErr = aSumErr / (double) array_elements;
-  *bAvgErr = bSumErr / (double) array_elements;
-  *cAvgErr = cSumErr / (double) array_elements;
+  stype->errors( a, b, c, array_elements, expected, avgErr );
+  *aAvgErr = avgErr[0];
+  *bAvgErr = avgErr[1];
+  *cAvgErr = avgErr[2];
 }
 
 
 int
 HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
   double *copyGBs, double *scaleGBs, double *addGBs, double *triadGBs, int *failure) {
-    int quantum,  BytesPerWord, numranks, myrank;
-    int j, k;
-    double  scalar, t, t0, t1, times[4][NTIMES], times_copy[4][NTIMES];
+    int quantum,  BytesPerWord, numranks, myrank, thp, star;
+    int j, k, kernels;
+#ifndef TUNED
+    size_t i;
+#endif
+    long pageSize;
+    double  scalar, t, t0, t1, times[STREAM_KERNELS][NTIMES], times_copy[STREAM_KERNELS][NTIMES];
     FILE *outFile;
     double GiBs = 1024.0 * 1024.0 * 1024.0, curGBs;
-    double AvgError[3] = {0.0,0.0,0.0};
-    double *AvgErrByRank;
+    double AvgError[4] = {0.0,0.0,0.0,0.0};
+    double *AvgErrByRank, GBs[STREAM_KERNELS];
+    char *saved = NULL;
 
 
     if (doIO) {
@@ -410,19 +1277,30 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
     MPI_Comm_size( comm, &numranks );
     MPI_Comm_rank( comm, &myrank );
 
-    array_elements = HPCC_LocalVectorSize( params, 3, sizeof(double), 0 ); /* Need 3 vectors */
+    /* the extra measurements are only done in StarSTREAM so that SingleSTREAM (which runs on
+       MPI_COMM_SELF) does not overwrite their results */
+    MPI_Comm_compare( comm, MPI_COMM_WORLD, &k );
+    star = MPI_IDENT == k;
+
+    type = Mmin( Mmax( params->StreamType, 0 ), HPCC_STREAM_TYPES - 1 );
+    stype = HPCC_StreamTypes + type;
+    for (j = 0; j < STREAM_KERNELS; j++)
+      bytes[j] = words[j] * stype->size;
+    bytes[7] += sizeof(size_t);
+
+    array_elements = HPCC_LocalVectorSizeLong( params, 3, stype->size, 0 ); /* Need 3 vectors */
     params->StreamVectorSize = array_elements;
 
-    a = HPCC_XMALLOC( double, array_elements );
-    b = HPCC_XMALLOC( double, array_elements );
-    c = HPCC_XMALLOC( double, array_elements );
+    a = HPCC_PagesAlloc( array_elements * stype->size, params->StreamHugePages );
+    b = HPCC_PagesAlloc( array_elements * stype->size, params->StreamHugePages );
+    c = HPCC_PagesAlloc( array_elements * stype->size, params->StreamHugePages );
 
     if (!a || !b || !c) {
-      if (c) HPCC_free(c);
-      if (b) HPCC_free(b);
-      if (a) HPCC_free(a);
+      if (c) HPCC_PagesFree( c, array_elements * stype->size, params->StreamHugePages );
+      if (b) HPCC_PagesFree( b, array_elements * stype->size, params->StreamHugePages );
+      if (a) HPCC_PagesFree( a, array_elements * stype->size, params->StreamHugePages );
       if (doIO) {
-        fprintf( outFile, "Failed to allocate memory (%d).\n", array_elements );
+        fprintf( outFile, "Failed to allocate memory (" FSTR64 ").\n", (s64Int)array_elements );
         fflush( outFile );
         fclose( outFile );
       }
@@ -434,18 +1312,18 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
 
     if (doIO) {
     fprintf( outFile, HLINE);
-    BytesPerWord = sizeof(double);
-    fprintf( outFile, "This system uses %d bytes per DOUBLE PRECISION word.\n",
-             BytesPerWord);
+    BytesPerWord = stype->size;
+    fprintf( outFile, "This system uses %d bytes per %s word.\n",
+             BytesPerWord, type ? stype->name : "DOUBLE PRECISION");
 
     fprintf( outFile, HLINE);
-    fprintf( outFile, "Array size = %d, Offset = %d\n" , array_elements, OFFSET);
+    fprintf( outFile, "Array size = " FSTR64 ", Offset = %d\n" , (s64Int)array_elements, OFFSET);
     fprintf( outFile, "Total memory required = %.4f GiB.\n",
              (3.0 * BytesPerWord) * ( (double) array_elements / GiBs));
     fprintf( outFile, "Each test is run %d times.\n", NTIMES );
     fprintf( outFile, " The *best* time for each kernel (excluding the first iteration)\n" );
     fprintf( outFile, " will be used to compute the reported bandwidth.\n");
-    fprintf( outFile, "The SCALAR value used for this run is %f\n", SCALAR );
+    fprintf( outFile, "The SCALAR value used for this run is %f\n", STREAM_SCALAR );
 
     }
 
@@ -464,13 +1342,57 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
 
     /* --- SETUP --- initialize arrays and estimate precision of timer --- */
 
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-    for (j=0; j<array_elements; j++) {
-      a[j] = 1.0;
-      b[j] = 2.0;
-      c[j] = 0.0;
+    if (params->StreamNUMA) {
+      k = ! StreamNUMAInit( array_elements, &saved );
+      MPI_Allreduce( &k, &j, 1, MPI_INT, MPI_MIN, comm ); /* all ranks have to agree on the mode */
+      if (! j) {
+        if (part) StreamNUMAFinalize( saved );
+        if (doIO) fprintf( outFile, "Failed to set up NUMA mode, using default placement.\n" );
+      }
+    }
+
+    /* kernel variants exist only for double */
+    variant = type ? -1 : StreamSelect( part && ! params->StreamKernels ? 1 : params->StreamKernels, comm );
+    if (star) params->StreamKernelsUsed = variant + 1;
+    if (doIO) {
+      if (type)
+        fprintf( outFile, "Kernels: %s\n", stype->name );
+      else if (variant < 0)
+        fprintf( outFile, "Kernels: tuned_STREAM\n" );
+      else
+        fprintf( outFile, "Kernels: %s\n", HPCC_StreamVariants[variant].name );
+    }
+
+    if (part) {
+      if (doIO) fprintf( outFile, "NUMA mode: vectors split between %d bound threads\n", partCount );
+    } else {
+      StreamRun( 8, 0.0, -1, array_elements, 1 );
+    }
+
+    /* the page size is known only after the vectors were touched */
+    pageSize = HPCC_PageSize( a, &thp );
+    if (star) params->StreamPageSize = pageSize;
+    if (doIO) {
+      if (pageSize < 0)
+        fprintf( outFile, "Page size: unknown\n" );
+      else if (thp > 0)
+        fprintf( outFile, "Page size: %ld KiB (transparent huge pages back %d%% of the vector)\n",
+                 pageSize / 1024, thp );
+      else
+        fprintf( outFile, "Page size: %ld KiB\n", pageSize / 1024 );
+    }
+
+    /* indices for the gather Triad are set up after the vectors so they do not affect their placement */
+    kernels = 4;
+    if (params->StreamExtraKernels) {
+      kernels = STREAM_KERNELS;
+      stride = Mmax( params->StreamStride, 1 );
+      bytes[6] /= stride;
+      idx = HPCC_XMALLOC( size_t, array_elements );
+      if (idx)
+        StreamGatherInit();
+      else if (doIO)
+        fprintf( outFile, "Failed to allocate memory for gather indices (" FSTR64 ").\n", (s64Int)array_elements );
     }
 
     /* Rank 0 needs to allocate arrays to hold error data and timing data from
@@ -479,8 +1401,8 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
        have been instantiated -- so there is no possibility of having these
        auxiliary arrays mess up the NUMA placement of the primary arrays. */
 
-    /* There are 3 average error values for each rank (using double). */
-    AvgErrByRank = HPCC_XMALLOC( double, 3 * numranks );
+    /* There are 3 average error values and the relative error of the sum for each rank (using double). */
+    AvgErrByRank = HPCC_XMALLOC( double, 4 * numranks );
 
     /* There are 4*NTIMES timing values for each rank (always doubles) */
     if (AvgErrByRank == NULL) {
@@ -490,7 +1412,7 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
     }
 
     /* FIXME: replace with loop to use floating-point data */
-    memset(AvgErrByRank,0,3*sizeof(double)*numranks);
+    memset(AvgErrByRank,0,4*sizeof(double)*numranks);
 
     if (doIO) fprintf( outFile, HLINE);
 
@@ -505,11 +1427,7 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
     /* Get initial timing estimate to compare to timer granularity.
        All ranks need to run this code since it changes the values in array `a' */
     t = MPI_Wtime();
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-    for (j = 0; j < array_elements; j++)
-      a[j] = 2.0E0 * a[j];
+    StreamRun( 9, 0.0, -1, array_elements, 1 );
     t = 1.0E6 * (MPI_Wtime() - t);
 
     if (doIO) {
@@ -537,69 +1455,132 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
        this should not cause a problem for arrays that are large enough to satisfy
        the STREAM run rules. */
 
-    scalar = SCALAR;
+    if (params->StreamThreadTimes && star) {
+#ifdef _OPENMP
+      threadMax = part ? partCount : omp_get_max_threads();
+#else
+      threadMax = 1;
+#endif
+      threadTimes = HPCC_XMALLOC( double, 4 * NTIMES * threadMax );
+      threadElements = HPCC_XMALLOC( size_t, threadMax );
+      threadCPU = HPCC_XMALLOC( int, threadMax );
+      if (! threadTimes || ! threadElements || ! threadCPU) {
+        if (threadCPU) HPCC_free( threadCPU );
+        if (threadElements) HPCC_free( threadElements );
+        if (threadTimes) HPCC_free( threadTimes );
+        threadTimes = NULL;
+        if (doIO) fprintf( outFile, "Failed to allocate memory for per-thread timing.\n" );
+      }
+    }
+
+    scalar = STREAM_SCALAR;
     for (k=0; k<NTIMES; k++) {
+        threadIter = k;
+
         /* kernel 1: Copy */
         MPI_Barrier( comm );
         times[0][k] = MPI_Wtime();
+        if (part || variant >= 0 || threadTimes || type)
+          StreamRun( 0, scalar, -1, array_elements, 1 );
+        else {
 #ifdef TUNED
         tuned_STREAM_Copy();
 #else
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-        for (j=0; j<array_elements; j++)
-          c[j] = a[j];
+        for (i=0; i<array_elements; i++)
+          c[i] = a[i];
 #endif
+        }
         MPI_Barrier( comm );
         times[0][k] = MPI_Wtime() - times[0][k];
 
         /* kernel 2: Scale */
         MPI_Barrier( comm );
         times[1][k] = MPI_Wtime();
+        if (part || variant >= 0 || threadTimes || type)
+          StreamRun( 1, scalar, -1, array_elements, 1 );
+        else {
 #ifdef TUNED
         tuned_STREAM_Scale(scalar);
 #else
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-        for (j=0; j<array_elements; j++)
-          b[j] = scalar*c[j];
+        for (i=0; i<array_elements; i++)
+          b[i] = scalar*c[i];
 #endif
+        }
         MPI_Barrier( comm );
         times[1][k] = MPI_Wtime() - times[1][k];
 
         /* kernel 3: Add */
         MPI_Barrier( comm );
         times[2][k] = MPI_Wtime();
+        if (part || variant >= 0 || threadTimes || type)
+          StreamRun( 2, scalar, -1, array_elements, 1 );
+        else {
 #ifdef TUNED
         tuned_STREAM_Add();
 #else
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-        for (j=0; j<array_elements; j++)
-          c[j] = a[j]+b[j];
+        for (i=0; i<array_elements; i++)
+          c[i] = a[i]+b[i];
 #endif
+        }
         MPI_Barrier( comm );
         times[2][k] = MPI_Wtime() - times[2][k];
 
         /* kernel 4: Triad */
         MPI_Barrier( comm );
         times[3][k] = MPI_Wtime();
+        if (part || variant >= 0 || threadTimes || type)
+          StreamRun( 3, scalar, -1, array_elements, 1 );
+        else {
 #ifdef TUNED
         tuned_STREAM_Triad(scalar);
 #else
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-        for (j=0; j<array_elements; j++)
-          a[j] = b[j]+scalar*c[j];
+        for (i=0; i<array_elements; i++)
+          a[i] = b[i]+scalar*c[i];
 #endif
+        }
         MPI_Barrier( comm );
         times[3][k] = MPI_Wtime() - times[3][k];
     }
 
+    /* --- EXTRA KERNELS --- after the main loop all elements of each vector are equal, so the fill
+       (with the current value of c[]), the strided Triad, and the gather Triad do not change them
+       and the validation covers these kernels as well; the Sum kernel reads a[] NTIMES times */
+    sum = 0.0;
+    for (k=0; k<NTIMES && kernels > 4; k++)
+      for (j=4; j<kernels; j++) {
+        MPI_Barrier( comm );
+        times[j][k] = MPI_Wtime();
+        if (j != 7 || idx)
+          StreamRun( j, 5 == j ? stype->get( c, 0 ) : scalar, -1, array_elements, 1 );
+        MPI_Barrier( comm );
+        times[j][k] = MPI_Wtime() - times[j][k];
+      }
+    if (kernels > 4) {
+      double expected[3];
+
+      stype->expected( STREAM_SCALAR, NTIMES, expected );
+      AvgError[3] = fabs( sum / (expected[0] * array_elements * NTIMES) - 1.0 );
+    }
+
+    /* --- PROBE --- only in StarSTREAM; Triad leaves the vectors as they are so the validation
+       covers the probe as well */
+    if (params->StreamProbe && star) {
+      StreamProbe( params, outFile, doIO, comm, world_rank );
+      if (doIO) fprintf( outFile, HLINE);
+    }
+
     t0 = MPI_Wtime();
 
     /* --- SUMMARY --- */
@@ -611,12 +1592,12 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
     memcpy(times_copy, times, sizeof times_copy );
 
     /* for each iteration and each kernel, collect the minimum time across all MPI ranks */
-    MPI_Allreduce( times_copy, times, 4*NTIMES, MPI_DOUBLE, MPI_MIN, comm );
+    MPI_Allreduce( times_copy, times, kernels*NTIMES, MPI_DOUBLE, MPI_MIN, comm );
 
     /* Back to the original code, but now using the minimum global timing across all ranks */
     for (k=1; k<NTIMES; k++) /* note -- skip first iteration */
     {
-      for (j=0; j<4; j++)
+      for (j=0; j<kernels; j++)
       {
         avgtime[j] = avgtime[j] + times[j][k];
         mintime[j] = Mmin(mintime[j], times[j][k]);
@@ -626,7 +1607,7 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
 
     if (doIO)
       fprintf( outFile, "Function      Rate (GB/s)   Avg time     Min time     Max time\n");
-    for (j=0; j<4; j++) {
+    for (j=0; j<kernels; j++) {
       avgtime[j] /= (double)(NTIMES - 1); /* note -- skip first iteration */
 
       /* make sure no division by zero */
@@ -638,12 +1619,19 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
                  avgtime[j],
                  mintime[j],
                  maxtime[j]);
+      GBs[j] = curGBs;
       switch (j) {
         case 0: *copyGBs = curGBs; break;
         case 1: *scaleGBs = curGBs; break;
         case 2: *addGBs = curGBs; break;
         case 3: *triadGBs = curGBs; break;
       }
+      if (star) switch (j) {
+        case 4: params->StreamSumGBs = curGBs; break;
+        case 5: params->StreamFillGBs = curGBs; break;
+        case 6: params->StreamStridedTriadGBs = curGBs; break;
+        case 7: params->StreamGatherTriadGBs = idx ? curGBs : -1.0; break;
+      }
     }
     if (doIO)
       fprintf( outFile, HLINE);
@@ -651,7 +1639,7 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
     /* --- Every Rank Checks its Results --- */
     computeSTREAMerrors(&AvgError[0], &AvgError[1], &AvgError[2]);
     /* --- Collect the Average Errors for Each Array on Rank 0 --- */
-    MPI_Gather(AvgError, 3, MPI_DOUBLE, AvgErrByRank, 3, MPI_DOUBLE, 0, comm);
+    MPI_Gather(AvgError, 4, MPI_DOUBLE, AvgErrByRank, 4, MPI_DOUBLE, 0, comm);
 
     /* -- Combined averaged errors and report on Rank 0 only --- */
     if (myrank == 0) {
@@ -659,11 +1647,61 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
       if (doIO) fprintf( outFile, HLINE);
     }
 
+    /* --- Rates of individual threads --- */
+    if (params->StreamThreadTimes && star) {
+      StreamThreadReport( params, outFile, doIO, comm );
+      if (doIO) fprintf( outFile, HLINE);
+      if (threadTimes) {
+        HPCC_free( threadCPU );
+        HPCC_free( threadElements );
+        HPCC_free( threadTimes );
+        threadTimes = NULL;
+      }
+    }
+
+    /* --- Measure all kernel variants --- */
+    if (params->StreamAllKernels && star) {
+      StreamVariants( params, outFile, doIO, comm );
+      if (doIO) fprintf( outFile, HLINE);
+    }
+
+    /* --- Software prefetching at different distances --- */
+    if (params->StreamPrefetch && star) {
+      StreamPrefetch( params, outFile, doIO, comm );
+      if (doIO) fprintf( outFile, HLINE);
+    }
+
+    /* --- Bandwidth as a function of the working set size --- */
+    if (params->StreamSweep && star) {
+      StreamSweep( params, outFile, doIO, comm );
+      if (doIO) fprintf( outFile, HLINE);
+    }
+
+    /* --- Node bandwidth as a function of the number of active ranks per node --- */
+    if (params->StreamContention && numranks > 1) {
+      StreamContention( params, outFile, doIO, comm );
+      if (doIO) fprintf( outFile, HLINE);
+    }
+
+    /* --- NUMA mode: measure each node on its own --- */
+    if (part) {
+      if (star) {
+        StreamNUMASockets( params, outFile, doIO, comm, GBs );
+        if (doIO) fprintf( outFile, HLINE);
+      }
+      StreamNUMAFinalize( saved );
+    }
+
     HPCC_free(AvgErrByRank);
 
-    HPCC_free(c);
-    HPCC_free(b);
-    HPCC_free(a);
+    if (idx) {
+      HPCC_free( idx );
+      idx = NULL;
+    }
+
+    HPCC_PagesFree( c, array_elements * stype->size, params->StreamHugePages );
+    HPCC_PagesFree( b, array_elements * stype->size, params->StreamHugePages );
+    HPCC_PagesFree( a, array_elements * stype->size, params->StreamHugePages );
 
     if (doIO) {
       fflush( outFile );
@@ -675,7 +1713,7 @@ HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
 
 void tuned_STREAM_Copy()
 {
-  int j;
+  size_t j;
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
@@ -685,7 +1723,7 @@ void tuned_STREAM_Copy()
 
 void tuned_STREAM_Scale(double scalar)
 {
-  int j;
+  size_t j;
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
@@ -695,7 +1733,7 @@ void tuned_STREAM_Scale(double scalar)
 
 void tuned_STREAM_Add()
 {
-  int j;
+  size_t j;
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
@@ -705,7 +1743,7 @@ void tuned_STREAM_Add()
 
 void tuned_STREAM_Triad(double scalar)
 {
-  int j;
+  size_t j;
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
@@ -0,0 +1,56 @@
+/* -*- mode: C; tab-width: 2; indent-tabs-mode: nil; fill-column: 79; coding: iso-latin-1-unix -*- */
+
+#ifndef HPCC_STREAM_H
+#define HPCC_STREAM_H 1
+
+/* Portion of the STREAM vectors owned by a single thread in NUMA mode */
+typedef struct {
+  size_t lo, hi; /* range of vector elements: [lo, hi) */
+  int cpu;       /* CPU the thread runs on or -1 if unknown */
+  int node;      /* NUMA node of the CPU */
+} HPCC_StreamPart;
+
+typedef void (*HPCC_StreamKernel)(double * restrict d, double * restrict x, double * restrict y,
+  double s, size_t n);
+
+/* Implementation of the four kernels: Copy, Scale, Add, and Triad */
+typedef struct {
+  char *name;
+  HPCC_StreamKernel kernel[4];
+} HPCC_StreamVariant;
+
+extern HPCC_StreamVariant HPCC_StreamVariants[HPCC_STREAM_VARIANTS];
+
+#define HPCC_STREAM_TYPES 3
+
+/* Runs kernel `kernel' on elements [lo, hi): 0-3 are Copy, Scale, Add, and Triad, 4-7 are the sum,
+   the fill, the strided Triad, and the gather Triad, 8 initializes the vectors, and 9 doubles `a';
+   returns the partial result of the sum */
+typedef double (*HPCC_StreamTypedKernel)(int kernel, void *a, void *b, void *c, size_t *idx,
+  int stride, double s, size_t lo, size_t hi);
+
+/* Element type of the vectors */
+typedef struct {
+  char *name;
+  size_t size;
+  int integer;    /* non-zero for integer types, which use an integer scalar */
+  double epsilon; /* largest relative error allowed by the validation */
+  HPCC_StreamTypedKernel range;
+  void (*errors)(void *a, void *b, void *c, size_t n, double *expected, double *avgErr);
+  void (*expected)(double scalar, int ntimes, double *expected);
+  double (*get)(void *v, size_t j);
+} HPCC_StreamType;
+
+extern HPCC_StreamType HPCC_StreamTypes[HPCC_STREAM_TYPES];
+extern int HPCC_StreamVariantAvailable(int v);
+
+extern int HPCC_StreamCPUs(int **list);
+extern int HPCC_StreamBind(int cpu, void *saved);
+extern void HPCC_StreamUnbind(void *saved);
+extern int HPCC_StreamCurrentCPU(void);
+extern int HPCC_StreamCPUNode(int cpu);
+extern size_t HPCC_StreamMaskSize(void);
+extern int HPCC_StreamToNode(void *ptr, size_t size, int node);
+extern double HPCC_StreamMisplaced(void *ptr, size_t size, int node);
+
+#endif
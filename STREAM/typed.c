@@ -0,0 +1,92 @@
+/* -*- mode: C; tab-width: 2; indent-tabs-mode: nil; fill-column: 79; coding: iso-latin-1-unix -*- */
+/*
+  STREAM kernels for the element types selectable at runtime.
+
+  Every type gets the same set of functions generated from a macro: the
+  kernels (the four STREAM kernels, the extra kernels, and the array
+  initialization), the computation of the average errors, and the values the
+  arrays are expected to hold after the main loop. The arithmetic is done in
+  the element type so the validation checks what the kernels actually
+  compute. Integer types use an integer scalar so that no conversions are
+  needed in the kernels. The only exception is Sum: its partial sums are
+  accumulated in double so that they cannot overflow the integer type.
+ */
+
+#include <hpcc.h>
+
+#include "stream.h"
+
+#define HPCC_STREAM_TYPED(T, sfx) \
+static double \
+sfx##Range(int kernel, void *va, void *vb, void *vc, size_t *idx, int stride, double scalar, \
+  size_t lo, size_t hi) { \
+  T * restrict a = (T *)va, * restrict b = (T *)vb, * restrict c = (T *)vc, s = (T)scalar; \
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0; \
+  size_t j; \
+  switch (kernel) { \
+    case 0: for (j = lo; j < hi; j++) c[j] = a[j]; break; \
+    case 1: for (j = lo; j < hi; j++) b[j] = s*c[j]; break; \
+    case 2: for (j = lo; j < hi; j++) c[j] = a[j]+b[j]; break; \
+    case 3: for (j = lo; j < hi; j++) a[j] = b[j]+s*c[j]; break; \
+    case 4: /* four partial sums to hide the latency of additions */ \
+      for (j = lo; j + 4 <= hi; j += 4) { \
+        s0 += (double)a[j]; s1 += (double)a[j+1]; s2 += (double)a[j+2]; s3 += (double)a[j+3]; \
+      } \
+      for (; j < hi; j++) s0 += (double)a[j]; \
+      return s0 + s1 + s2 + s3; \
+    case 5: for (j = lo; j < hi; j++) c[j] = s; break; \
+    case 6: \
+      for (j = (lo + stride - 1) / stride * stride; j < hi; j += stride) a[j] = b[j]+s*c[j]; \
+      break; \
+    case 7: for (j = lo; j < hi; j++) a[j] = b[idx[j]]+s*c[j]; break; \
+    case 8: for (j = lo; j < hi; j++) { a[j] = 1; b[j] = 2; c[j] = 0; } break; \
+    case 9: for (j = lo; j < hi; j++) a[j] = 2 * a[j]; break; \
+  } \
+  return 0.0; \
+} \
+static void \
+sfx##Errors(void *va, void *vb, void *vc, size_t n, double *expected, double *avgErr) { \
+  T *a = (T *)va, *b = (T *)vb, *c = (T *)vc; \
+  T aj = (T)expected[0], bj = (T)expected[1], cj = (T)expected[2]; \
+  double aSumErr = 0.0, bSumErr = 0.0, cSumErr = 0.0; \
+  size_t j; \
+  for (j = 0; j < n; j++) { \
+    aSumErr += fabs( (double)(a[j] - aj) ); \
+    bSumErr += fabs( (double)(b[j] - bj) ); \
+    cSumErr += fabs( (double)(c[j] - cj) ); \
+  } \
+  avgErr[0] = aSumErr / (double)n; \
+  avgErr[1] = bSumErr / (double)n; \
+  avgErr[2] = cSumErr / (double)n; \
+} \
+static void \
+sfx##Expected(double scalar, int ntimes, double *expected) { \
+  T aj = 1, bj = 2, cj = 0, s = (T)scalar; \
+  int k; \
+  aj = 2 * aj; /* a[] is modified during timing check */ \
+  for (k = 0; k < ntimes; k++) { \
+    cj = aj; \
+    bj = s*cj; \
+    cj = aj+bj; \
+    aj = bj+s*cj; \
+  } \
+  expected[0] = (double)aj; \
+  expected[1] = (double)bj; \
+  expected[2] = (double)cj; \
+} \
+static double \
+sfx##Get(void *v, size_t j) { \
+  return (double)((T *)v)[j]; \
+}
+
+HPCC_STREAM_TYPED(double, Double)
+HPCC_STREAM_TYPED(float, Float)
+HPCC_STREAM_TYPED(s64Int, Int64)
+
+#define HPCC_STREAM_TYPE(sfx) sfx##Range, sfx##Errors, sfx##Expected, sfx##Get
+
+HPCC_StreamType HPCC_StreamTypes[HPCC_STREAM_TYPES] = {
+  {"double", sizeof(double), 0, 1.e-13, HPCC_STREAM_TYPE(Double)},
+  {"float", sizeof(float), 0, 1.e-6, HPCC_STREAM_TYPE(Float)},
+  {"int64", sizeof(s64Int), 1, 0.0, HPCC_STREAM_TYPE(Int64)}
+};
@@ -19,6 +19,7 @@ mpi.h
 #include <time.h>
 
 #define MPIFFT_TIMING_COUNT 8
+#define HPCC_STREAM_VARIANTS 6
 
 /* Define 64-bit types and corresponding format strings for printf() and constants */
 #ifdef LONG_IS_64BITS
@@ -66,7 +67,10 @@ typedef struct {
   int PTRANSnpqs, PTRANSpval[2 * HPL_MAX_PARAM], PTRANSqval[2 * HPL_MAX_PARAM];
   double MPIRandomAccess_LCG_GUPs, MPIRandomAccess_GUPs, Star_LCG_GUPs, Single_LCG_GUPs, StarGUPs, SingleGUPs,
     MPIRandomAccess_ErrorsFraction, MPIRandomAccess_time, MPIRandomAccess_CheckTime,
-    MPIRandomAccess_TimeBound,
+    MPIRandomAccess_TimeBound, MPIRandomAccess_RMA_GUPs, MPIRandomAccess_RMA_time,
+    MPIRandomAccess_Node_GUPs, MPIRandomAccess_Node_time,
+    MPIRandomAccess_PredictedTime, MPIRandomAccess_LCG_PredictedTime,
+    RandomAccessTimeBound, RandomAccessSampleFraction, RandomAccessSampleTolerance,
     MPIRandomAccess_LCG_ErrorsFraction, MPIRandomAccess_LCG_time, MPIRandomAccess_LCG_CheckTime,
     MPIRandomAccess_LCG_TimeBound,
     StarStreamCopyGBs, StarStreamScaleGBs,
@@ -78,9 +82,35 @@ typedef struct {
     MinPingPongLatency, AvgPingPongLatency, MaxPingPongBandwidth, AvgPingPongBandwidth,
     NaturallyOrderedRingLatency;
   int DGEMM_N;
-  int StreamThreads, StreamVectorSize;
-  int FFT_N;
-  int MPIFFT_Procs;
+  int StreamThreads;
+  s64Int StreamVectorSize;
+  int StreamNUMA, StreamNUMANodes;
+  double StreamNUMASocketMinTriadGBs, StreamNUMASocketMaxTriadGBs;
+  int StreamKernels, StreamAllKernels, StreamKernelsUsed;
+  double StreamVariantTriadGBs[HPCC_STREAM_VARIANTS];
+  int StreamSweep, StreamSweepMin, StreamSweepSteps, StreamSweepPoints;
+  double StreamSweepMinTriadGBs, StreamSweepMaxTriadGBs;
+  int StreamHugePages;
+  long StreamPageSize;
+  int StreamThreadTimes, StreamSlowestRank, StreamSlowestThread;
+  double StreamThreadMinTriadGBs, StreamThreadMaxTriadGBs, StreamThreadStdDevTriadGBs;
+  int StreamExtraKernels, StreamStride;
+  double StreamSumGBs, StreamFillGBs, StreamStridedTriadGBs, StreamGatherTriadGBs;
+  int StreamContention, StreamContentionRanks, StreamContentionBestRanks;
+  double StreamContentionMaxNodeTriadGBs;
+  int StreamType;
+  int StreamProbe, StreamProbeIterations, StreamProbeSamples;
+  double StreamProbeSeconds, StreamProbeInterval, StreamProbeSlice;
+  double StreamProbeMinTriadGBs, StreamProbeAvgTriadGBs, StreamProbeMaxTriadGBs;
+  int StreamPrefetch, StreamPrefetchMax, StreamPrefetchDistance[4];
+  int RandomAccessThreads, RandomAccessThreadSweep, RandomAccessAtomic, RandomAccessUsedThreads;
+  int RandomAccessHugePages, RandomAccessInterleave, RandomAccessInterleaveNodes;
+  int RandomAccessRMA, RandomAccessHierarchical, RandomAccessSampleRounds;
+  int RandomAccessBulkCheck, RandomAccessCheckChunk, RandomAccessGenerator;
+  long RandomAccessPageSize;
+  double StreamPrefetchGBs[4];
+  int FFT_N, FFTKernels, FFTKernelsUsed, StarFFTThreads, SingleFFTThreads, FFTWisdom;
+  int MPIFFT_Procs, MPIFFTPipeline, MPIFFTPencil, MPIFFTPipelineUsed, MPIFFTPencilUsed;
   int MPIRandomAccess_LCG_Algorithm, MPIRandomAccess_Algorithm;
 
   HPL_RuntimeData HPLrdata;
@@ -101,7 +131,8 @@ typedef struct {
 
   int FFTEnblk, FFTEnp, FFTEl2size;
   s64Int RandomAccess_LCG_N, RandomAccess_N, MPIRandomAccess_LCG_ExeUpdates, MPIRandomAccess_ExeUpdates,
-    MPIRandomAccess_LCG_N, MPIRandomAccess_N, MPIRandomAccess_LCG_Errors, MPIRandomAccess_Errors, MPIFFT_N;
+    MPIRandomAccess_LCG_N, MPIRandomAccess_N, MPIRandomAccess_LCG_Errors, MPIRandomAccess_Errors, MPIFFT_N,
+    MPIRandomAccess_RMA_Errors, MPIRandomAccess_Node_Errors;
 } HPCC_Params;
 /*
 This is what needs to be done to add a new benchmark:
@@ -123,6 +154,7 @@ int HPCC_external_finalize(int argc, char *argv[], void *extdata);
 extern int HPCC_Init(HPCC_Params *params);
 extern int HPCC_Finalize(HPCC_Params *params);
 extern int HPCC_LocalVectorSize(HPCC_Params *params, int vecCnt, size_t size, int pow2);
+extern size_t HPCC_LocalVectorSizeLong(HPCC_Params *params, int vecCnt, size_t size, int pow2);
 extern int
 HPCC_Defaults(HPL_T_test *TEST, int *NS, int *N,
               int *NBS, int *NB,
@@ -155,14 +187,22 @@ extern int HPCC_StarFFT(HPCC_Params *params);
 extern int HPCC_SingleFFT(HPCC_Params *params);
 extern int HPCC_MPIFFT(HPCC_Params *params);
 
-extern int HPCC_TestFFT(HPCC_Params *params, int doIO, double *UGflops, int *Un, int *Ufailure);
+extern int HPCC_TestFFT(HPCC_Params *params, int doIO, double *UGflops, int *Un, int *Uthreads,
+  int *Ufailure);
+extern void HPCC_fftw_forget_plans(void);
 extern int HPCC_TestDGEMM(HPCC_Params *params, int doIO, double *UGflops, int *Un, int *Ufailure);
 extern int MaxMem(int nprocs, int imrow, int imcol, int nmat, int *mval, int *nval, int nbmat,
   int *mbval, int *nbval, int ngrids, int *npval, int *nqval, long *maxMem);
 extern int HPCC_Stream(HPCC_Params *params, int doIO, MPI_Comm comm, int world_rank,
   double *copyGBs, double *scaleGBs, double *addGBs, double *triadGBs,
   int *failure);
+extern char *HPCC_StreamVariantName(int v);
+extern char *HPCC_StreamKernelName(int k);
 extern void main_bench_lat_bw(HPCC_Params *params);
+extern void *HPCC_PagesAlloc(size_t size, int huge);
+extern void HPCC_PagesFree(void *ptr, size_t size, int huge);
+extern long HPCC_PageSize(void *ptr, int *thp);
+extern int HPCC_Interleave(void *ptr, size_t size);
 
 extern int pdtrans(char *trans, int *m, int *n, int * mb, int *nb, double *a, int *lda,
   double *beta, double *c__, int *ldc, int *imrow, int *imcol, double *work, int *iwork);
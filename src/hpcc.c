@@ -274,6 +274,9 @@ main(int argc, char *argv[]) {
 
   if (params.RunSingleFFT) HPCC_SingleFFT( &params );
 
+  /* the FFT plans are cached until the last FFT test; free them before HPL sizes its matrix */
+  HPCC_fftw_forget_plans();
+
   time( &currentTime );
   BEGIN_IO( myRank, outFname, outputFile);
   fprintf( outputFile,"Current time (%ld) is %s\n",(long)currentTime,ctime(&currentTime));
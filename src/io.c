@@ -6,6 +6,7 @@
 #include <hpcc.h>
 
 #include <ctype.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
 
@@ -75,6 +76,131 @@ icopy(int n, int *src, int sinc, int *dst, int dinc) {
   }
 }
 
+/*
+  Optional settings that may follow the PTRANS lines of the input file. Each
+  setting takes one line of the form "Name=value". Settings that are not
+  present in the input file keep their default values.
+ */
+#define HPCC_OPT_INT 1
+#define HPCC_OPT_DBL 2
+
+static struct {
+  char *name;
+  int type;
+  size_t offset;
+  double dflt;
+} HPCC_Options[] = {
+  {"STREAM_NUMA", HPCC_OPT_INT, offsetof(HPCC_Params, StreamNUMA), 0.0},
+  {"STREAM_Kernels", HPCC_OPT_INT, offsetof(HPCC_Params, StreamKernels), 0.0},
+  {"STREAM_AllKernels", HPCC_OPT_INT, offsetof(HPCC_Params, StreamAllKernels), 0.0},
+  {"STREAM_Sweep", HPCC_OPT_INT, offsetof(HPCC_Params, StreamSweep), 0.0},
+  {"STREAM_SweepMin", HPCC_OPT_INT, offsetof(HPCC_Params, StreamSweepMin), 16384.0},
+  {"STREAM_SweepSteps", HPCC_OPT_INT, offsetof(HPCC_Params, StreamSweepSteps), 2.0},
+  {"STREAM_HugePages", HPCC_OPT_INT, offsetof(HPCC_Params, StreamHugePages), 0.0},
+  {"STREAM_ThreadTimes", HPCC_OPT_INT, offsetof(HPCC_Params, StreamThreadTimes), 0.0},
+  {"STREAM_ExtraKernels", HPCC_OPT_INT, offsetof(HPCC_Params, StreamExtraKernels), 0.0},
+  {"STREAM_Stride", HPCC_OPT_INT, offsetof(HPCC_Params, StreamStride), 8.0},
+  {"STREAM_Contention", HPCC_OPT_INT, offsetof(HPCC_Params, StreamContention), 0.0},
+  {"STREAM_Type", HPCC_OPT_INT, offsetof(HPCC_Params, StreamType), 0.0},
+  {"STREAM_Probe", HPCC_OPT_INT, offsetof(HPCC_Params, StreamProbe), 0.0},
+  {"STREAM_ProbeSeconds", HPCC_OPT_DBL, offsetof(HPCC_Params, StreamProbeSeconds), 10.0},
+  {"STREAM_ProbeIterations", HPCC_OPT_INT, offsetof(HPCC_Params, StreamProbeIterations), 0.0},
+  {"STREAM_ProbeInterval", HPCC_OPT_DBL, offsetof(HPCC_Params, StreamProbeInterval), 0.1},
+  {"STREAM_ProbeSlice", HPCC_OPT_DBL, offsetof(HPCC_Params, StreamProbeSlice), 0.01},
+  {"STREAM_Prefetch", HPCC_OPT_INT, offsetof(HPCC_Params, StreamPrefetch), 0.0},
+  {"STREAM_PrefetchMax", HPCC_OPT_INT, offsetof(HPCC_Params, StreamPrefetchMax), 8192.0},
+  {"RA_Threads", HPCC_OPT_INT, offsetof(HPCC_Params, RandomAccessThreads), 0.0},
+  {"RA_ThreadSweep", HPCC_OPT_INT, offsetof(HPCC_Params, RandomAccessThreadSweep), 0.0},
+  {"RA_Atomic", HPCC_OPT_INT, offsetof(HPCC_Params, RandomAccessAtomic), 0.0},
+  {"RA_HugePages", HPCC_OPT_INT, offsetof(HPCC_Params, RandomAccessHugePages), 0.0},
+  {"RA_Interleave", HPCC_OPT_INT, offsetof(HPCC_Params, RandomAccessInterleave), 0.0},
+  {"RA_RMA", HPCC_OPT_INT, offsetof(HPCC_Params, RandomAccessRMA), 0.0},
+  {"RA_Hierarchical", HPCC_OPT_INT, offsetof(HPCC_Params, RandomAccessHierarchical), 0.0},
+  {"RA_TimeBound", HPCC_OPT_DBL, offsetof(HPCC_Params, RandomAccessTimeBound), 60.0},
+  {"RA_SampleFraction", HPCC_OPT_DBL, offsetof(HPCC_Params, RandomAccessSampleFraction), 0.01},
+  {"RA_SampleRounds", HPCC_OPT_INT, offsetof(HPCC_Params, RandomAccessSampleRounds), 1.0},
+  {"RA_SampleTolerance", HPCC_OPT_DBL, offsetof(HPCC_Params, RandomAccessSampleTolerance), 0.05},
+  {"RA_BulkCheck", HPCC_OPT_INT, offsetof(HPCC_Params, RandomAccessBulkCheck), 0.0},
+  {"RA_CheckChunk", HPCC_OPT_INT, offsetof(HPCC_Params, RandomAccessCheckChunk), 1048576.0},
+  {"RA_Generator", HPCC_OPT_INT, offsetof(HPCC_Params, RandomAccessGenerator), 0.0},
+  {"FFT_Kernels", HPCC_OPT_INT, offsetof(HPCC_Params, FFTKernels), 0.0},
+  {"FFT_Wisdom", HPCC_OPT_INT, offsetof(HPCC_Params, FFTWisdom), 0.0},
+  {"MPIFFT_Pipeline", HPCC_OPT_INT, offsetof(HPCC_Params, MPIFFTPipeline), 0.0},
+  {"MPIFFT_Pencil", HPCC_OPT_INT, offsetof(HPCC_Params, MPIFFTPencil), 0.0},
+  {NULL, 0, 0, 0.0}
+};
+
+static void
+HPCC_OptionsDefault(HPCC_Params *params) {
+  int i;
+  char *p;
+
+  for (i = 0; HPCC_Options[i].name; i++) {
+    p = (char *)params + HPCC_Options[i].offset;
+    if (HPCC_OPT_INT == HPCC_Options[i].type)
+      *(int *)p = (int)HPCC_Options[i].dflt;
+    else
+      *(double *)p = HPCC_Options[i].dflt;
+  }
+}
+
+/* returns 0 if the line holds a known setting or is blank */
+static int
+HPCC_OptionRead(HPCC_Params *params, char *buf) {
+  int i;
+  size_t n;
+  double v;
+  char *p, *s;
+
+  for (s = buf; *s && isspace( *s ); s++)
+    ; /* EMPTY */
+  if (! *s || '#' == *s) return 0;
+
+  p = strchr( s, '=' );
+  if (! p) return 1;
+  for (n = p - s; n && isspace( s[n-1] ); n--)
+    ; /* EMPTY */
+
+  for (i = 0; HPCC_Options[i].name; i++)
+    if (strlen( HPCC_Options[i].name ) == n && strncmp( HPCC_Options[i].name, s, n ) == 0)
+      break;
+
+  if (! HPCC_Options[i].name || sscanf( p + 1, "%lf", &v ) != 1) return 1;
+
+  p = (char *)params + HPCC_Options[i].offset;
+  if (HPCC_OPT_INT == HPCC_Options[i].type)
+    *(int *)p = (int)v;
+  else
+    *(double *)p = v;
+
+  return 0;
+}
+
+static void
+HPCC_OptionsBcast(HPCC_Params *params, MPI_Comm comm) {
+  int i;
+  char *p;
+
+  for (i = 0; HPCC_Options[i].name; i++) {
+    p = (char *)params + HPCC_Options[i].offset;
+    MPI_Bcast( p, 1, HPCC_OPT_INT == HPCC_Options[i].type ? MPI_INT : MPI_DOUBLE, 0, comm );
+  }
+}
+
+static void
+HPCC_OptionsPrint(HPCC_Params *params, FILE *f) {
+  int i;
+  char *p;
+
+  for (i = 0; HPCC_Options[i].name; i++) {
+    p = (char *)params + HPCC_Options[i].offset;
+    if (HPCC_OPT_INT == HPCC_Options[i].type)
+      fprintf( f, "%s=%d\n", HPCC_Options[i].name, *(int *)p );
+    else
+      fprintf( f, "%s=%g\n", HPCC_Options[i].name, *(double *)p );
+  }
+}
+
 int
 HPCC_InputFileInit(HPCC_Params *params) {
   int myRank, commSize;
@@ -86,6 +212,8 @@ HPCC_InputFileInit(HPCC_Params *params) {
   MPI_Comm_size( comm, &commSize );
   MPI_Comm_rank( comm, &myRank );
 
+  HPCC_OptionsDefault( params );
+
   if (0 == myRank) {
     f = fopen( params->inFname, "r" );
     if (! f) {
@@ -155,6 +283,16 @@ HPCC_InputFileInit(HPCC_Params *params) {
     icopy( params->nbs, params->nbval, 1, params->PTRANSnbval + n, 1 );
     params->PTRANSnbs = n + params->nbs;
 
+    /* Get optional settings */
+    while (fgets( buf, nbuf, f )) {
+      line++;
+      if (HPCC_OptionRead( params, buf )) {
+        BEGIN_IO( myRank, params->outFname, outputFile );
+        fprintf( outputFile, "Unknown setting in line %d of the input file.\n", line );
+        END_IO( myRank, outputFile );
+      }
+    }
+
     ioErr = 0;
     ioEnd:
     if (f) fclose( f );
@@ -180,6 +318,8 @@ HPCC_InputFileInit(HPCC_Params *params) {
   if (params->PTRANSnbs > 0)
     MPI_Bcast( &params->PTRANSnbval, params->PTRANSnbs, MPI_INT, 0, comm );
 
+  HPCC_OptionsBcast( params, comm );
+
   /* copy what HPL has */
   params->PTRANSnpqs = params->npqs;
   icopy( params->npqs, params->qval, 1, params->PTRANSqval, 1 );
@@ -313,16 +453,55 @@ HPCC_Init(HPCC_Params *params) {
   params->MPIRandomAccess_LCG_time = params->MPIRandomAccess_LCG_CheckTime =
   params->MPIRandomAccess_time = params->MPIRandomAccess_CheckTime =
   params->MPIRandomAccess_LCG_TimeBound =
-  params->MPIRandomAccess_TimeBound = -1.0;
+  params->MPIRandomAccess_TimeBound =
+  params->MPIRandomAccess_RMA_GUPs = params->MPIRandomAccess_RMA_time =
+  params->MPIRandomAccess_Node_GUPs = params->MPIRandomAccess_Node_time =
+  params->MPIRandomAccess_PredictedTime = params->MPIRandomAccess_LCG_PredictedTime = -1.0;
 
   params->DGEMM_N =
   params->FFT_N =
-  params->StreamVectorSize =
   params->MPIRandomAccess_LCG_Algorithm =
   params->MPIRandomAccess_Algorithm =
-  params->MPIFFT_Procs = -1;
+  params->MPIFFT_Procs =
+  params->MPIFFTPipelineUsed =
+  params->MPIFFTPencilUsed = -1;
 
   params->StreamThreads = 1;
+  params->RandomAccessUsedThreads = 1;
+  params->StarFFTThreads = params->SingleFFTThreads = 1;
+  params->RandomAccessInterleaveNodes = 0;
+  params->RandomAccessPageSize = -1;
+  params->StreamVectorSize = -1;
+  params->StreamPageSize = -1;
+
+  params->StreamNUMANodes = -1;
+  params->StreamNUMASocketMinTriadGBs = params->StreamNUMASocketMaxTriadGBs = -1.0;
+
+  params->StreamKernelsUsed = -1;
+  params->FFTKernelsUsed = -1;
+  for (i = 0; i < HPCC_STREAM_VARIANTS; i++)
+    params->StreamVariantTriadGBs[i] = -1.0;
+
+  params->StreamSweepPoints = 0;
+  params->StreamSweepMinTriadGBs = params->StreamSweepMaxTriadGBs = -1.0;
+
+  params->StreamSlowestRank = params->StreamSlowestThread = -1;
+  params->StreamThreadMinTriadGBs = params->StreamThreadMaxTriadGBs =
+  params->StreamThreadStdDevTriadGBs = -1.0;
+
+  params->StreamSumGBs = params->StreamFillGBs = params->StreamStridedTriadGBs =
+  params->StreamGatherTriadGBs = -1.0;
+
+  params->StreamContentionRanks = params->StreamContentionBestRanks = -1;
+  params->StreamContentionMaxNodeTriadGBs = -1.0;
+
+  params->StreamProbeSamples = 0;
+  params->StreamProbeMinTriadGBs = params->StreamProbeAvgTriadGBs = params->StreamProbeMaxTriadGBs = -1.0;
+
+  for (i = 0; i < 4; i++) {
+    params->StreamPrefetchDistance[i] = -1;
+    params->StreamPrefetchGBs[i] = -1.0;
+  }
 
   params->FFTEnblk = params->FFTEnp = params->FFTEl2size = -1;
 
@@ -334,7 +513,9 @@ HPCC_Init(HPCC_Params *params) {
   params->MPIRandomAccess_N =
   params->MPIRandomAccess_Errors =
   params->MPIRandomAccess_LCG_ExeUpdates =
-  params->MPIRandomAccess_ExeUpdates = (s64Int)(-1);
+  params->MPIRandomAccess_ExeUpdates =
+  params->MPIRandomAccess_RMA_Errors =
+  params->MPIRandomAccess_Node_Errors = (s64Int)(-1);
 
   procMax = procMin = params->pval[0] * params->qval[0];
   for (i = 1; i < params->npqs; ++i) {
@@ -469,6 +650,7 @@ HPCC_Finalize(HPCC_Params *params) {
   fprintf( outputFile, "MPIRandomAccess_LCG_ExeUpdates=" FSTR64 "\n", params->MPIRandomAccess_LCG_ExeUpdates );
   fprintf( outputFile, "MPIRandomAccess_LCG_GUPs=%g\n", params->MPIRandomAccess_LCG_GUPs );
   fprintf( outputFile, "MPIRandomAccess_LCG_TimeBound=%g\n", params->MPIRandomAccess_LCG_TimeBound );
+  fprintf( outputFile, "MPIRandomAccess_LCG_PredictedTime=%g\n", params->MPIRandomAccess_LCG_PredictedTime );
   fprintf( outputFile, "MPIRandomAccess_LCG_Algorithm=%d\n", params->MPIRandomAccess_LCG_Algorithm );
   fprintf( outputFile, "MPIRandomAccess_N=" FSTR64 "\n", params->MPIRandomAccess_N );
   fprintf( outputFile, "MPIRandomAccess_time=%g\n", params->MPIRandomAccess_time );
@@ -478,15 +660,57 @@ HPCC_Finalize(HPCC_Params *params) {
   fprintf( outputFile, "MPIRandomAccess_ExeUpdates=" FSTR64 "\n", params->MPIRandomAccess_ExeUpdates );
   fprintf( outputFile, "MPIRandomAccess_GUPs=%g\n", params->MPIRandomAccess_GUPs );
   fprintf( outputFile, "MPIRandomAccess_TimeBound=%g\n", params->MPIRandomAccess_TimeBound );
+  fprintf( outputFile, "MPIRandomAccess_PredictedTime=%g\n", params->MPIRandomAccess_PredictedTime );
   fprintf( outputFile, "MPIRandomAccess_Algorithm=%d\n", params->MPIRandomAccess_Algorithm );
+  fprintf( outputFile, "MPIRandomAccess_RMA_time=%g\n", params->MPIRandomAccess_RMA_time );
+  fprintf( outputFile, "MPIRandomAccess_RMA_Errors=" FSTR64 "\n", params->MPIRandomAccess_RMA_Errors );
+  fprintf( outputFile, "MPIRandomAccess_RMA_GUPs=%g\n", params->MPIRandomAccess_RMA_GUPs );
+  fprintf( outputFile, "MPIRandomAccess_Node_time=%g\n", params->MPIRandomAccess_Node_time );
+  fprintf( outputFile, "MPIRandomAccess_Node_Errors=" FSTR64 "\n", params->MPIRandomAccess_Node_Errors );
+  fprintf( outputFile, "MPIRandomAccess_Node_GUPs=%g\n", params->MPIRandomAccess_Node_GUPs );
   fprintf( outputFile, "RandomAccess_LCG_N=" FSTR64 "\n", params->RandomAccess_LCG_N );
   fprintf( outputFile, "StarRandomAccess_LCG_GUPs=%g\n", params->Star_LCG_GUPs );
   fprintf( outputFile, "SingleRandomAccess_LCG_GUPs=%g\n", params->Single_LCG_GUPs );
   fprintf( outputFile, "RandomAccess_N=" FSTR64 "\n", params->RandomAccess_N );
   fprintf( outputFile, "StarRandomAccess_GUPs=%g\n", params->StarGUPs );
   fprintf( outputFile, "SingleRandomAccess_GUPs=%g\n", params->SingleGUPs );
-  fprintf( outputFile, "STREAM_VectorSize=%d\n", params->StreamVectorSize );
+  fprintf( outputFile, "RandomAccess_Threads=%d\n", params->RandomAccessUsedThreads );
+  fprintf( outputFile, "RandomAccess_Generator=%d\n", params->RandomAccessGenerator );
+  fprintf( outputFile, "RandomAccess_PageSize=%ld\n", params->RandomAccessPageSize );
+  fprintf( outputFile, "RandomAccess_InterleaveNodes=%d\n", params->RandomAccessInterleaveNodes );
+  fprintf( outputFile, "STREAM_VectorSize=" FSTR64 "\n", params->StreamVectorSize );
+  fprintf( outputFile, "STREAM_PageSize=%ld\n", params->StreamPageSize );
   fprintf( outputFile, "STREAM_Threads=%d\n", params->StreamThreads );
+  fprintf( outputFile, "STREAM_NUMANodes=%d\n", params->StreamNUMANodes );
+  fprintf( outputFile, "STREAM_NUMASocketMinTriad=%g\n", params->StreamNUMASocketMinTriadGBs );
+  fprintf( outputFile, "STREAM_NUMASocketMaxTriad=%g\n", params->StreamNUMASocketMaxTriadGBs );
+  fprintf( outputFile, "STREAM_KernelsUsed=%d\n", params->StreamKernelsUsed );
+  for (i = 0; i < HPCC_STREAM_VARIANTS; i++)
+    fprintf( outputFile, "STREAM_Triad_%s=%g\n", HPCC_StreamVariantName( i ), params->StreamVariantTriadGBs[i] );
+  fprintf( outputFile, "STREAM_SweepPoints=%d\n", params->StreamSweepPoints );
+  fprintf( outputFile, "STREAM_SweepMinTriad=%g\n", params->StreamSweepMinTriadGBs );
+  fprintf( outputFile, "STREAM_SweepMaxTriad=%g\n", params->StreamSweepMaxTriadGBs );
+  fprintf( outputFile, "STREAM_ThreadMinTriad=%g\n", params->StreamThreadMinTriadGBs );
+  fprintf( outputFile, "STREAM_ThreadMaxTriad=%g\n", params->StreamThreadMaxTriadGBs );
+  fprintf( outputFile, "STREAM_ThreadStdDevTriad=%g\n", params->StreamThreadStdDevTriadGBs );
+  fprintf( outputFile, "STREAM_SlowestRank=%d\n", params->StreamSlowestRank );
+  fprintf( outputFile, "STREAM_SlowestThread=%d\n", params->StreamSlowestThread );
+  fprintf( outputFile, "STREAM_Sum=%g\n", params->StreamSumGBs );
+  fprintf( outputFile, "STREAM_Fill=%g\n", params->StreamFillGBs );
+  fprintf( outputFile, "STREAM_StridedTriad=%g\n", params->StreamStridedTriadGBs );
+  fprintf( outputFile, "STREAM_GatherTriad=%g\n", params->StreamGatherTriadGBs );
+  fprintf( outputFile, "STREAM_ContentionRanks=%d\n", params->StreamContentionRanks );
+  fprintf( outputFile, "STREAM_ContentionBestRanks=%d\n", params->StreamContentionBestRanks );
+  fprintf( outputFile, "STREAM_ContentionMaxNodeTriad=%g\n", params->StreamContentionMaxNodeTriadGBs );
+  fprintf( outputFile, "STREAM_ProbeSamples=%d\n", params->StreamProbeSamples );
+  fprintf( outputFile, "STREAM_ProbeMinTriad=%g\n", params->StreamProbeMinTriadGBs );
+  fprintf( outputFile, "STREAM_ProbeAvgTriad=%g\n", params->StreamProbeAvgTriadGBs );
+  fprintf( outputFile, "STREAM_ProbeMaxTriad=%g\n", params->StreamProbeMaxTriadGBs );
+  for (i = 0; i < 4; i++) {
+    fprintf( outputFile, "STREAM_Prefetch%sDistance=%d\n", HPCC_StreamKernelName( i ),
+             params->StreamPrefetchDistance[i] );
+    fprintf( outputFile, "STREAM_Prefetch%s=%g\n", HPCC_StreamKernelName( i ), params->StreamPrefetchGBs[i] );
+  }
   fprintf( outputFile, "StarSTREAM_Copy=%g\n", params->StarStreamCopyGBs );
   fprintf( outputFile, "StarSTREAM_Scale=%g\n", params->StarStreamScaleGBs );
   fprintf( outputFile, "StarSTREAM_Add=%g\n", params->StarStreamAddGBs );
@@ -498,10 +722,15 @@ HPCC_Finalize(HPCC_Params *params) {
   fprintf( outputFile, "FFT_N=%d\n", params->FFT_N );
   fprintf( outputFile, "StarFFT_Gflops=%g\n",   params->StarFFTGflops );
   fprintf( outputFile, "SingleFFT_Gflops=%g\n", params->SingleFFTGflops );
+  fprintf( outputFile, "FFT_KernelsUsed=%d\n", params->FFTKernelsUsed );
+  fprintf( outputFile, "StarFFT_Threads=%d\n", params->StarFFTThreads );
+  fprintf( outputFile, "SingleFFT_Threads=%d\n", params->SingleFFTThreads );
   fprintf( outputFile, "MPIFFT_N=" FSTR64 "\n", params->MPIFFT_N );
   fprintf( outputFile, "MPIFFT_Gflops=%g\n", params->MPIFFTGflops );
   fprintf( outputFile, "MPIFFT_maxErr=%g\n", params->MPIFFT_maxErr );
   fprintf( outputFile, "MPIFFT_Procs=%d\n", params->MPIFFT_Procs );
+  fprintf( outputFile, "MPIFFT_PipelineUsed=%d\n", params->MPIFFTPipelineUsed );
+  fprintf( outputFile, "MPIFFT_PencilUsed=%d\n", params->MPIFFTPencilUsed );
   fprintf( outputFile, "MaxPingPongLatency_usec=%g\n", params->MaxPingPongLatency );
   fprintf( outputFile, "RandomlyOrderedRingLatency_usec=%g\n", params->RandomlyOrderedRingLatency );
   fprintf( outputFile, "MinPingPongBandwidth_GBytes=%g\n", params->MinPingPongBandwidth );
@@ -515,6 +744,7 @@ HPCC_Finalize(HPCC_Params *params) {
   fprintf( outputFile, "FFTEnblk=%d\n", params->FFTEnblk );
   fprintf( outputFile, "FFTEnp=%d\n", params->FFTEnp );
   fprintf( outputFile, "FFTEl2size=%d\n", params->FFTEl2size );
+  HPCC_OptionsPrint( params, outputFile );
 
 #ifdef _OPENMP
   fprintf( outputFile, "M_OPENMP=%ld\n", (long)(_OPENMP) );
@@ -562,6 +792,12 @@ HPCC_Finalize(HPCC_Params *params) {
 #endif
   fprintf( outputFile, "CPS_HPCC_MEMALLCTR=%d\n", i );
 
+  i = 0;
+#ifdef HPCC_USE_LIBNUMA
+  i = 1;
+#endif
+  fprintf( outputFile, "CPS_HPCC_USE_LIBNUMA=%d\n", i );
+
   i = 0;
 #ifdef HPL_USE_GETPROCESSTIMES
   i = 1;
@@ -601,25 +837,36 @@ HPCC_Finalize(HPCC_Params *params) {
 
 int
 HPCC_LocalVectorSize(HPCC_Params *params, int vecCnt, size_t size, int pow2) {
-  int flg2, maxIntBits2;
+  int maxIntBits2;
+  size_t n;
 
   /* this is the maximum power of 2 that that can be held in a signed integer (for a 4-byte
      integer, 2**31-1 is the maximum integer, so the maximum power of 2 is 30) */
   maxIntBits2 = sizeof(int) * 8 - 2;
 
-  /* flg2 = floor(log2(params->HPLMaxProcMem / size / vecCnt)) */
-  for (flg2 = 1; params->HPLMaxProcMem / size / vecCnt >> flg2; ++flg2)
-    ; /* EMPTY */
-  --flg2;
+  n = HPCC_LocalVectorSizeLong( params, vecCnt, size, pow2 );
+
+  if (n >> (maxIntBits2 + 1))
+    return 1 << maxIntBits2;
+
+  return (int)n;
+}
 
-  if (flg2 <= maxIntBits2) {
-    if (pow2)
-      return 1 << flg2;
+/* Same as HPCC_LocalVectorSize() but the size is not limited by the range of int */
+size_t
+HPCC_LocalVectorSizeLong(HPCC_Params *params, int vecCnt, size_t size, int pow2) {
+  int flg2;
+
+  if (pow2) {
+    /* flg2 = floor(log2(params->HPLMaxProcMem / size / vecCnt)) */
+    for (flg2 = 1; params->HPLMaxProcMem / size / vecCnt >> flg2; ++flg2)
+      ; /* EMPTY */
+    --flg2;
 
-    return params->HPLMaxProcMem / size / vecCnt;
+    return (size_t)1 << flg2;
   }
 
-  return 1 << maxIntBits2;
+  return params->HPLMaxProcMem / size / vecCnt;
 }
 
 int
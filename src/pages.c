@@ -0,0 +1,163 @@
+/* -*- mode: C; tab-width: 2; indent-tabs-mode: nil; fill-column: 79; coding: iso-latin-1-unix -*- */
+/*
+  Allocation of the STREAM vectors and RandomAccess tables with huge pages.
+
+  Explicit huge pages (2 MiB or 1 GiB) come from hugetlbfs with MAP_HUGETLB
+  and need to be reserved by the administrator beforehand (see
+  /proc/sys/vm/nr_hugepages). If they cannot be obtained, the memory is
+  aligned to 2 MiB and transparent huge pages are requested with
+  madvise(MADV_HUGEPAGE). The page size that was actually obtained is read
+  from /proc/self/smaps after the memory was touched.
+
+  If HPCC_USE_LIBNUMA is defined then libnuma is used to interleave the pages
+  over the NUMA nodes.
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <hpcc.h>
+
+#ifdef HPCC_USE_LIBNUMA
+#include <numa.h>
+#endif
+
+#ifdef __linux__
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+#define HPCC_PAGES_THP (2UL << 20)
+
+/* Size of the mapping made for `size' bytes in mode `huge' */
+static size_t
+MapSize(size_t size, int huge) {
+  size_t pg = huge > 2 ? (1UL << 30) : HPCC_PAGES_THP;
+  return (size + pg - 1) / pg * pg;
+}
+#endif
+
+/* Allocates `size' bytes: with malloc() if `huge' is 0, with transparent huge pages if it is 1,
+   and with 2 MiB (2) or 1 GiB (3) pages from hugetlbfs, falling back to transparent huge pages. */
+void *
+HPCC_PagesAlloc(size_t size, int huge) {
+#ifdef __linux__
+  char *p, *q;
+  size_t mapSize;
+
+  if (huge <= 0) return HPCC_XMALLOC( char, size );
+
+  mapSize = MapSize( size, huge );
+
+  if (huge > 1) {
+    p = mmap( NULL, mapSize, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (huge > 2 ? MAP_HUGE_1GB : MAP_HUGE_2MB), -1, 0 );
+    if (p != MAP_FAILED) return p;
+  }
+
+  /* over-allocate to align the memory to the size of transparent huge pages and trim the rest; the
+     mapping keeps the size rounded for `huge' so that it can be freed without knowing which kind of
+     pages was obtained (the part beyond `size' is never touched) */
+  p = mmap( NULL, mapSize + HPCC_PAGES_THP, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+  if (MAP_FAILED == p) return NULL;
+
+  q = (char *)(((size_t)p + HPCC_PAGES_THP - 1) / HPCC_PAGES_THP * HPCC_PAGES_THP);
+  if (q > p) munmap( p, q - p );
+  munmap( q + mapSize, p + HPCC_PAGES_THP - q );
+
+#ifdef MADV_HUGEPAGE
+  madvise( q, mapSize, MADV_HUGEPAGE );
+#endif
+
+  return q;
+#else
+  return HPCC_XMALLOC( char, size );
+#endif
+}
+
+void
+HPCC_PagesFree(void *ptr, size_t size, int huge) {
+#ifdef __linux__
+  if (huge <= 0) {
+    HPCC_free( ptr );
+    return;
+  }
+
+  /* hugetlbfs mappings have to be unmapped in whole pages of their size */
+  munmap( ptr, MapSize( size, huge ) );
+#else
+  HPCC_free( ptr );
+#endif
+}
+
+/* Interleaves the pages that are entirely within [ptr, ptr+size) over all NUMA nodes; returns the
+   number of nodes or -1 if the memory policy cannot be set */
+int
+HPCC_Interleave(void *ptr, size_t size) {
+#ifdef HPCC_USE_LIBNUMA
+  size_t pg;
+  char *lo, *hi;
+
+  if (numa_available() < 0) return -1;
+
+  pg = numa_pagesize();
+  lo = (char *)(((size_t)ptr + pg - 1) / pg * pg);
+  hi = (char *)(((size_t)ptr + size) / pg * pg);
+
+  if (hi > lo) numa_interleave_memory( lo, hi - lo, numa_all_nodes_ptr );
+
+  return numa_bitmask_weight( numa_all_nodes_ptr );
+#else
+  (void)ptr; (void)size;
+  return -1;
+#endif
+}
+
+/* Returns the size of the pages backing `ptr' or -1 if unknown. Transparent huge pages count if
+   they back at least half of the mapping; `thp' is set to the percentage of the mapping they back. */
+long
+HPCC_PageSize(void *ptr, int *thp) {
+  long pageSize = -1;
+#ifdef __linux__
+  FILE *f;
+  char line[256];
+  unsigned long lo, hi, mapLo = 0, mapHi = 1, addr = (unsigned long)ptr;
+  long kB;
+  int inside = 0;
+
+  *thp = 0;
+
+  f = fopen( "/proc/self/smaps", "r" );
+  if (! f) return -1;
+
+  while (fgets( line, sizeof line, f )) {
+    if (sscanf( line, "%lx-%lx", &lo, &hi ) == 2) {
+      if (inside) break; /* past the mapping */
+      inside = lo <= addr && addr < hi;
+      mapLo = lo;
+      mapHi = hi;
+    } else if (inside && sscanf( line, "KernelPageSize: %ld kB", &kB ) == 1) {
+      pageSize = kB * 1024;
+    } else if (inside && sscanf( line, "AnonHugePages: %ld kB", &kB ) == 1) {
+      *thp = (int)(100.0 * kB * 1024 / (mapHi - mapLo));
+    }
+  }
+
+  fclose( f );
+
+  if (*thp >= 50 && pageSize < (long)HPCC_PAGES_THP) pageSize = HPCC_PAGES_THP;
+#else
+  *thp = 0;
+#endif
+
+  return pageSize;
+}
@@ -72,21 +72,22 @@ allDeps = (
      ("pddriver", "pdinfo", "pdtest"), ""),
 
     ("../RandomAccess/", (hhpcc, hhpl, "../../../../RandomAccess/RandomAccess.h",
-                          "../../../../RandomAccess/buckets.h", "../../../../RandomAccess/heap.h",
-                          "../../../../RandomAccess/pool.h", "../../../../RandomAccess/time_bound.h"),
-     ("MPIRandomAccess", "buckets", "core_single_cpu_lcg", "core_single_cpu", "heap", "pool", "single_cpu_lcg",
-      "single_cpu", "star_single_cpu_lcg", "star_single_cpu", "time_bound", "time_bound_lcg", "utility", "verification_lcg", "verification",
-      "MPIRandomAccess_vanilla", "MPIRandomAccess_opt", "MPIRandomAccessLCG", "MPIRandomAccessLCG_vanilla",
-      "MPIRandomAccessLCG_opt"), "-I../../../../include $(CCFLAGS)"),
+                          "../../../../RandomAccess/buckets.h", "../../../../RandomAccess/time_bound.h",
+                          "../../../../RandomAccess/generator.h"),
+     ("MPIRandomAccess", "buckets", "core_single_cpu", "single_cpu_lcg",
+      "single_cpu", "star_single_cpu_lcg", "star_single_cpu", "time_bound", "utility", "verification",
+      "MPIRandomAccess_vanilla", "MPIRandomAccess_opt", "MPIRandomAccessLCG_vanilla",
+      "MPIRandomAccessLCG_opt", "MPIRandomAccess_rma",
+      "MPIRandomAccess_node", "generator"), "-I../../../../include $(CCFLAGS)"),
 
-    ("../STREAM/", (hhpcc, hhpl),
-     ("onecpu", "stream"), "-I../../../../include $(CCFLAGS)"),
+    ("../STREAM/", (hhpcc, hhpl, "../../../../STREAM/stream.h"),
+     ("onecpu", "stream", "numa", "kernels", "typed"), "-I../../../../include $(CCFLAGS)"),
 
     ("../PTRANS/", (hhpcc, hhpl, "../../../../PTRANS/cblacslt.h"),
      ("pmatgeninc", "pdmatgen", "pdtransdriver", "pdmatcmp", "pdtrans", "sclapack", "cblacslt", "mem"), "-I../../../../include $(CCFLAGS)"),
 
     ("../src/", (hhpcc, hhpccv, hhpccm, hhpl),
-     ("bench_lat_bw_1.5.2",  "hpcc",  "io", "extinit", "extfinalize"), "-I../../../../include $(CCFLAGS)"),
+     ("bench_lat_bw_1.5.2",  "hpcc",  "io", "extinit", "extfinalize", "pages"), "-I../../../../include $(CCFLAGS)"),
 
     ("../src/", (hhpcc, hhpl),
      ("HPL_slamch", "noopt"), "-I../../../../include $(CCNOOPT)"),
@@ -95,7 +96,7 @@ allDeps = (
      ("tstdgemm",  "onecpu"), "-I../../../../include $(CCFLAGS)"),
 
     ("../FFT/", (hhpcc, hhpl, "../../../../FFT/hpccfft.h", "../../../../FFT/wrapfftw.h", "../../../../FFT/wrapmpifftw.h"),
-     ("bcnrand", "fft235", "zfft1d", "pzfft1d", "onecpu", "tstfft", "wrapfftw", "wrapmpifftw", "mpifft"), "-I../../../../include $(CCFLAGS)")
+     ("bcnrand", "fft235", "fft235simd", "zfft1d", "pzfft1d", "onecpu", "tstfft", "wrapfftw", "wrapmpifftw", "mpifft"), "-I../../../../include $(CCFLAGS)")
 
     )
 